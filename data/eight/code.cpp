@@ -0,0 +1,135 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <vector>
+#include <string>
+#include "deque.hpp"
+#include "exceptions.hpp"
+
+/***************************/
+int N = 100000;
+/***************************/
+
+class T{
+private:
+	std::string s;
+public:
+	T(int x):s(std::to_string(x)){}
+	int num()const {return atoi(s.c_str());}
+};
+bool operator == (const T &a, const T &b){
+	return a.num() == b.num();
+}
+bool operator != (const T &a, const T &b){
+	return a.num() != b.num();
+}
+template<class Deque, class Stl>
+bool equal(Deque &q, Stl &stl){
+	if(q.size() != stl.size()) return 0;
+	if(q.empty() != stl.empty()) return 0;
+	typename Stl::iterator it_stl = stl.begin();
+	for(typename Deque::iterator it_q = q.begin(); it_q != q.end(); it_q++, it_stl++){
+		if(*it_q != *it_stl) return 0;
+	}
+	for(int i = 0; i < 100; i++){
+		int k = rand() % stl.size();
+		if(q[k] != stl[k]) return 0;
+	}
+	return 1;
+}
+void test1(){
+	printf("test1: range insert                  ");
+	sjtu::deque<T> q;
+	std::deque<T> stl;
+	for(int i = 0; i < N; i++){
+		q.push_back(T(i));
+		stl.push_back(T(i));
+	}
+	for(int t = 0; t < 20; t++){
+		std::vector<T> v;
+		int len = rand() % 5000;
+		for(int i = 0; i < len; i++) v.push_back(T(rand()));
+		int pos = rand() % (stl.size() + 1);
+		sjtu::deque<T>::iterator it = q.insert(q.begin() + pos, v.begin(), v.end());
+		stl.insert(stl.begin() + pos, v.begin(), v.end());
+		if(it - q.begin() != pos){puts("Wrong Answer");return;}
+	}
+	if(!equal(q, stl)){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+void test2(){
+	printf("test2: fill insert & append          ");
+	sjtu::deque<T> q;
+	std::deque<T> stl;
+	for(int t = 0; t < 50; t++){
+		int len = rand() % 3000 + 1;
+		int pos = rand() % (stl.size() + 1);
+		q.insert(q.begin() + pos, len, T(t));
+		stl.insert(stl.begin() + pos, len, T(t));
+		std::vector<T> v;
+		for(int i = 0; i < len; i++) v.push_back(T(i));
+		q.append(v.begin(), v.end());
+		stl.insert(stl.end(), v.begin(), v.end());
+	}
+	if(!equal(q, stl)){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+void test3(){
+	printf("test3: range erase                   ");
+	sjtu::deque<T> q;
+	std::deque<T> stl;
+	for(int i = 0; i < N; i++){
+		q.push_back(T(i));
+		stl.push_back(T(i));
+	}
+	while(stl.size() > 10){
+		int l = rand() % stl.size();
+		int r = l + rand() % (stl.size() - l + 1) / 4;
+		sjtu::deque<T>::iterator it = q.erase(q.begin() + l, q.begin() + r);
+		stl.erase(stl.begin() + l, stl.begin() + r);
+		if(it - q.begin() != l){puts("Wrong Answer");return;}
+		if(it != q.end() && *it != stl[l]){puts("Wrong Answer");return;}
+		if(!equal(q, stl)){puts("Wrong Answer");return;}
+	}
+	q.erase(q.begin(), q.end());
+	if(!q.empty() || !(q.begin() == q.end())){puts("Wrong Answer");return;}
+	q.push_back(T(1));
+	if(q.size() != 1 || q[0] != T(1)){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+void test4(){
+	printf("test4: insert & erase windows        ");
+	sjtu::deque<T> q;
+	std::deque<T> stl;
+	for(int i = 0; i < N; i++){
+		q.push_back(T(i));
+		stl.push_back(T(i));
+	}
+	for(int t = 0; t < 200; t++){
+		int pos = rand() % (stl.size() + 1);
+		if(t % 2 == 0){
+			int len = rand() % 2000;
+			q.insert(q.begin() + pos, len, T(-t));
+			stl.insert(stl.begin() + pos, len, T(-t));
+		}
+		else{
+			int len = rand() % (stl.size() - pos + 1);
+			q.erase(q.begin() + pos, q.begin() + pos + len);
+			stl.erase(stl.begin() + pos, stl.begin() + pos + len);
+		}
+		if(stl.empty()) continue;
+		if(q.front() != stl.front() || q.back() != stl.back()){puts("Wrong Answer");return;}
+	}
+	if(!equal(q, stl)){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+int main(){
+	srand(20);
+	puts("test start:");
+	test1();
+	test2();
+	test3();
+	test4();
+	return 0;
+}
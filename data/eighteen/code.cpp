@@ -0,0 +1,138 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <string>
+#include "deque.hpp"
+#include "exceptions.hpp"
+
+/***************************/
+int N = 1000;
+/***************************/
+
+// counts down on every construction from an int, copy and copy assignment, and throws when it reaches 0.
+int fuse = -1;
+struct Boom{};
+struct Bomb{
+	std::string s;
+	static std::string text(int x){
+		return std::string(40, 'a' + x % 26) + std::to_string(x);
+	}
+	static void tick(){
+		if(fuse > 0 && --fuse == 0) throw Boom();
+	}
+	Bomb(int x) : s(text(x)) {tick();}
+	Bomb(const Bomb &o) : s(o.s) {tick();}
+	Bomb(Bomb &&o) noexcept : s(std::move(o.s)) {}
+	Bomb &operator=(const Bomb &o){tick(); s = o.s; return *this;}
+	Bomb &operator=(Bomb &&o) noexcept {s = std::move(o.s); return *this;}
+};
+// small nodes, so that node boundaries come up often.
+typedef sjtu::deque<Bomb, 8> Deq;
+
+// q must hold exactly the values of ref, walked both by index and by iterator.
+bool same(const Deq &q, const std::deque<int> &ref){
+	if(q.size() != ref.size()) return false;
+	size_t i = 0;
+	for(Deq::const_iterator it = q.cbegin(); it != q.cend(); ++it, ++i){
+		if(i >= ref.size() || it -> s != Bomb::text(ref[i])) return false;
+	}
+	if(i != ref.size()) return false;
+	for(i = 0; i < ref.size(); i++){
+		if(q[i].s != Bomb::text(ref[i])) return false;
+	}
+	return ref.empty() || (q.front().s == Bomb::text(ref.front()) && q.back().s == Bomb::text(ref.back()));
+}
+// run op with the fuse set to go off at the n-th construction, it must throw Boom.
+template<class Op>
+bool blows(Op op, int n = 1){
+	fuse = n;
+	bool thrown = false;
+	try{
+		op();
+	}
+	catch(Boom &){
+		thrown = true;
+	}
+	fuse = -1;
+	return thrown;
+}
+
+void test1(){
+	printf("test1: emplace_front into the head ");
+	Deq q;
+	std::deque<int> ref;
+	// only front pushes, so the head holds i % 8 elements and has room unless that is 0.
+	for(int i = 1; i <= N; i++){
+		q.emplace_front(i), ref.push_front(i);
+		if(i % 8 == 0) continue;
+		if(!blows([&]{q.emplace_front(-1);})){puts("Wrong Answer");return;}
+		if(!same(q, ref)){puts("Wrong Answer");return;}
+	}
+	puts("Accept");
+}
+void test2(){
+	printf("test2: emplace at a full end node  ");
+	Deq q;
+	std::deque<int> ref;
+	for(int i = 0; i < N; i++){
+		if(i % 3 == 0) q.emplace_front(i), ref.push_front(i);
+		else q.emplace_back(i), ref.push_back(i);
+		if(!blows([&]{q.emplace_front(-1);}) || !blows([&]{q.emplace_back(-1);})){puts("Wrong Answer");return;}
+		if(!same(q, ref)){puts("Wrong Answer");return;}
+	}
+	puts("Accept");
+}
+void test3(){
+	printf("test3: emplace in the middle       ");
+	Deq q;
+	std::deque<int> ref;
+	for(int i = 0; i < N; i++){
+		size_t k = rand() % (ref.size() + 1);
+		q.emplace(q.begin() + k, i), ref.insert(ref.begin() + k, i);
+		k = rand() % (ref.size() + 1);
+		if(!blows([&]{q.emplace(q.begin() + k, -1);}) || !blows([&]{q.emplace(q.end(), -1);})){puts("Wrong Answer");return;}
+		if(!same(q, ref)){puts("Wrong Answer");return;}
+	}
+	puts("Accept");
+}
+void test4(){
+	printf("test4: copy construction throws    ");
+	Deq q;
+	for(int i = 0; i < 100; i++) q.emplace_back(i);
+	// every node allocated before the throw must be given back, ASan checks the leak.
+	for(int n = 1; n <= 100; n += 7){
+		if(!blows([&]{Deq c(q);}, n)){puts("Wrong Answer");return;}
+	}
+	puts("Accept");
+}
+void test5(){
+	printf("test5: copy assignment throws      ");
+	std::deque<int> small, big;
+	Deq a, b;
+	for(int i = 0; i < 30; i++) a.emplace_back(i), small.push_back(i);
+	for(int i = 0; i < 100; i++) b.emplace_front(i), big.push_front(i);
+	for(int n = 1; n <= 100; n += 3){
+		// onto a shorter deque, so the copy reuses its nodes and then links new ones.
+		Deq c(a);
+		if(!blows([&]{c = b;}, n) || !same(c, std::deque<int>())){puts("Wrong Answer");return;}
+		// onto a longer deque, so nodes past the copy are freed.
+		Deq d(b);
+		if(n <= 30 && (!blows([&]{d = a;}, n) || !same(d, std::deque<int>()))){puts("Wrong Answer");return;}
+		// an emptied deque is still a working one.
+		c = b;
+		d.emplace_front(1);
+		if(!same(c, big) || d.size() != (n <= 30 ? 1 : 101)){puts("Wrong Answer");return;}
+	}
+	puts("Accept");
+}
+int main(){
+	srand(18);
+	puts("test start:");
+	test1();
+	test2();
+	test3();
+	test4();
+	test5();
+	return 0;
+}
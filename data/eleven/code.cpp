@@ -0,0 +1,148 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include "deque.hpp"
+#include "exceptions.hpp"
+
+/***************************/
+int N = 100000;
+/***************************/
+
+typedef sjtu::deque<int, 64> Deque;
+
+void build(Deque &q, std::deque<int> &stl){
+	for(int i = 0; i < N; i++){
+		int v = rand() % 100;
+		int op = rand() % 4;
+		if(op == 0) q.push_back(v), stl.push_back(v);
+		else if(op == 1) q.push_front(v), stl.push_front(v);
+		else if(op == 2){
+			int pos = rand() % (stl.size() + 1);
+			q.insert(q.begin() + pos, v);
+			stl.insert(stl.begin() + pos, v);
+		}
+		else if(!stl.empty()){
+			int pos = rand() % stl.size();
+			q.erase(q.begin() + pos);
+			stl.erase(stl.begin() + pos);
+		}
+	}
+}
+struct sum{
+	unsigned long long s;
+	sum() : s(0) {}
+	void operator()(int x){ s = s * 31 + x; }
+};
+void test1(){
+	printf("test1: for_each & accumulate  ");
+	Deque q;
+	std::deque<int> stl;
+	build(q, stl);
+	for(int i = 0; i < 100; i++){
+		int l = rand() % (stl.size() + 1), r = rand() % (stl.size() + 1);
+		if(l > r) std::swap(l, r);
+		if(sjtu::segmented::for_each(q.cbegin() + l, q.cbegin() + r, sum()).s != std::for_each(stl.begin() + l, stl.begin() + r, sum()).s){puts("Wrong Answer");return;}
+		if(sjtu::segmented::accumulate(q.begin() + l, q.begin() + r, 0LL) != std::accumulate(stl.begin() + l, stl.begin() + r, 0LL)){puts("Wrong Answer");return;}
+	}
+	sjtu::segmented::for_each(q.begin(), q.end(), [](int &x){ x *= 3; });
+	for(size_t i = 0; i < stl.size(); i++){
+		if(q[i] != stl[i] * 3){puts("Wrong Answer");return;}
+	}
+	puts("Accept");
+}
+void test2(){
+	printf("test2: find & count           ");
+	Deque q;
+	std::deque<int> stl;
+	build(q, stl);
+	for(int i = 0; i < 200; i++){
+		int v = rand() % 110;
+		int l = rand() % (stl.size() + 1);
+		Deque::iterator it = sjtu::segmented::find(q.begin() + l, q.end(), v);
+		if(it - q.begin() != std::find(stl.begin() + l, stl.end(), v) - stl.begin()){puts("Wrong Answer");return;}
+		if(it != q.end() && *it != v){puts("Wrong Answer");return;}
+		if(sjtu::segmented::count(q.cbegin(), q.cend() - l, v) != std::count(stl.begin(), stl.end() - l, v)){puts("Wrong Answer");return;}
+	}
+	std::vector<int> vec(stl.begin(), stl.end());
+	if(sjtu::segmented::find(vec.begin(), vec.end(), vec.back()) - vec.begin() != std::find(stl.begin(), stl.end(), vec.back()) - stl.begin()){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+void test3(){
+	printf("test3: copy, fill & transform ");
+	Deque q;
+	std::deque<int> stl;
+	build(q, stl);
+	std::vector<int> out(stl.size());
+	if(sjtu::segmented::copy(q.begin(), q.end(), out.begin()) != out.end()){puts("Wrong Answer");return;}
+	if(!std::equal(out.begin(), out.end(), stl.begin())){puts("Wrong Answer");return;}
+	int l = stl.size() / 3, r = stl.size() / 2;
+	sjtu::segmented::fill(q.begin() + l, q.begin() + r, -1);
+	std::fill(stl.begin() + l, stl.begin() + r, -1);
+	sjtu::segmented::transform(q.cbegin(), q.cend(), q.begin(), [](int x){ return x * 2 + 1; });
+	std::transform(stl.begin(), stl.end(), stl.begin(), [](int x){ return x * 2 + 1; });
+	for(size_t i = 0; i < stl.size(); i++){
+		if(q[i] != stl[i]){puts("Wrong Answer");return;}
+	}
+	puts("Accept");
+}
+void test4(){
+	printf("test4: equal                  ");
+	Deque q, p;
+	std::deque<int> stl;
+	build(q, stl);
+	for(size_t i = 0; i < stl.size(); i++) p.push_front(stl[stl.size() - 1 - i]);
+	if(!sjtu::segmented::equal(q.begin(), q.end(), stl.begin()) || !sjtu::segmented::equal(q.cbegin(), q.cend(), p.cbegin())){puts("Wrong Answer");return;}
+	int k = rand() % stl.size();
+	stl[k]++;
+	if(sjtu::segmented::equal(q.begin(), q.end(), stl.begin())){puts("Wrong Answer");return;}
+	if(!sjtu::segmented::equal(q.begin(), q.begin() + k, stl.begin())){puts("Wrong Answer");return;}
+	if(!sjtu::segmented::equal(q.begin(), q.end(), stl.begin(), [](int a, int b){ return a / 2 == b / 2 || a == b - 1; })){puts("Wrong Answer");return;}
+	Deque e;
+	if(!sjtu::segmented::equal(e.begin(), e.end(), stl.begin()) || sjtu::segmented::count(e.begin(), e.end(), 0) != 0){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+void test5(){
+	printf("test5: segments               ");
+	Deque q;
+	std::deque<int> stl;
+	build(q, stl);
+	std::vector<int> out;
+	for(Deque::segment s : q.segments()){
+		if(s.len == 0 || s.len > 64){puts("Wrong Answer");return;}
+		out.insert(out.end(), s.data, s.data + s.len);
+	}
+	if(out.size() != stl.size() || !std::equal(out.begin(), out.end(), stl.begin())){puts("Wrong Answer");return;}
+	for(int i = 0; i < 100; i++){
+		int l = rand() % (stl.size() + 1), r = rand() % (stl.size() + 1);
+		if(l > r) std::swap(l, r);
+		const Deque &c = q;
+		size_t n = 0;
+		long long s1 = 0;
+		for(Deque::const_segment s : c.segments(c.cbegin() + l, c.cbegin() + r)){
+			for(size_t j = 0; j < s.len; j++) s1 += s.data[j] * (long long)(n + j);
+			n += s.len;
+		}
+		long long s2 = 0;
+		for(int j = l; j < r; j++) s2 += stl[j] * (long long)(j - l);
+		if(n != (size_t)(r - l) || s1 != s2){puts("Wrong Answer");return;}
+	}
+	for(Deque::segment s : q.segments()) std::fill(s.data, s.data + s.len, 7);
+	if(sjtu::segmented::count(q.begin(), q.end(), 7) != (long)stl.size()){puts("Wrong Answer");return;}
+	Deque e;
+	if(!e.segments().empty() || !q.segments(q.end(), q.end()).empty()){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+int main(){
+	srand(11);
+	puts("test start:");
+	test1();
+	test2();
+	test3();
+	test4();
+	test5();
+	return 0;
+}
@@ -0,0 +1,121 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <csignal>
+#include <csetjmp>
+#include <deque>
+#include "deque.hpp"
+#include "exceptions.hpp"
+
+/***************************/
+int N = 10000;
+/***************************/
+
+typedef sjtu::deque<int, 16, std::allocator<int>, sjtu::checked> Checked;
+typedef sjtu::deque<int, 16, std::allocator<int>, sjtu::debug_checked> Debug;
+typedef sjtu::deque<int, 16, std::allocator<int>, sjtu::unchecked> Unchecked;
+
+template<class Deque>
+bool works(){
+	Deque q;
+	std::deque<int> stl;
+	for(int i = 0; i < N; i++){
+		int pos = rand() % (stl.size() + 1);
+		q.insert(q.begin() + pos, i);
+		stl.insert(stl.begin() + pos, i);
+	}
+	const Deque &c = q;
+	static_assert(std::is_same<decltype(c.element(0)), const int &>::value && std::is_same<decltype(q.element(0)), int &>::value,
+		"a const deque must only hand out const elements");
+	for(int i = 0; i < N; i++){
+		int k = rand() % N;
+		if(q[k] != stl[k] || c.at(k) != stl[k] || c.element(k) != stl[k] || *(c.cbegin() + k) != stl[k] || q.begin()[k] != stl[k]) return 0;
+	}
+	if(q.front() != stl.front() || q.back() != stl.back() || *--c.cend() != stl.back() || q.end() - q.begin() != N) return 0;
+	// at() checks under every policy.
+	try{
+		q.at(N);
+		return 0;
+	}
+	catch(sjtu::index_out_of_bound &){}
+	return 1;
+}
+template<class E, class F>
+bool throws(F f){
+	try{
+		f();
+	}
+	catch(E &){
+		return 1;
+	}
+	return 0;
+}
+void test1(){
+	printf("test1: valid access under every policy ");
+	if(!works<Checked>() || !works<Debug>() || !works<Unchecked>()){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+void test2(){
+	printf("test2: checked throws                  ");
+	Checked q, e;
+	for(int i = 0; i < 100; i++) q.push_back(i);
+	const Checked &c = q;
+	bool ok = throws<sjtu::index_out_of_bound>([&]{ q[100]; })
+		&& throws<sjtu::container_is_empty>([&]{ e.front(); })
+		&& throws<sjtu::invalid_iterator>([&]{ *q.end(); })
+		&& throws<sjtu::invalid_iterator>([&]{ q.begin() - e.begin(); })
+		&& throws<sjtu::index_out_of_bound>([&]{ q.begin() + 101; })
+		&& throws<sjtu::index_out_of_bound>([&]{ --q.begin(); })
+		&& throws<sjtu::index_out_of_bound>([&]{ --c.cbegin(); });
+	if(!ok){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+std::jmp_buf env;
+void onAbort(int){
+	std::longjmp(env, 1);
+}
+template<class F>
+bool aborts(F f){
+	std::signal(SIGABRT, onAbort);
+	if(setjmp(env) == 0){
+		f();
+		std::signal(SIGABRT, SIG_DFL);
+		return 0;
+	}
+	std::signal(SIGABRT, SIG_DFL);
+	return 1;
+}
+void test3(){
+	printf("test3: debug_checked asserts           ");
+	Debug q, e;
+	for(int i = 0; i < 100; i++) q.push_back(i);
+	const Debug &c = q;
+	bool ok = !throws<sjtu::exception>([&]{ q[99]; });
+#ifndef NDEBUG
+	ok = ok && aborts([&]{ q[100]; }) && aborts([&]{ e.back(); }) && aborts([&]{ --c.cbegin(); });
+#endif
+	if(!ok){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+void test4(){
+	printf("test4: unchecked checks nothing        ");
+	// the policy itself: a broken precondition goes unnoticed.
+	bool ok = !throws<sjtu::index_out_of_bound>([]{ sjtu::unchecked::require<sjtu::index_out_of_bound>(false); })
+		&& throws<sjtu::index_out_of_bound>([]{ sjtu::checked::require<sjtu::index_out_of_bound>(false); });
+	Unchecked q;
+	for(int i = 0; i < 100; i++) q.push_front(i);
+	Unchecked::iterator it = q.end();
+	--it;
+	ok = ok && *it == 0 && q[0] == 99 && it - q.begin() == 99;
+	if(!ok){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+int main(){
+	srand(15);
+	puts("test start:");
+	test1();
+	test2();
+	test3();
+	test4();
+	return 0;
+}
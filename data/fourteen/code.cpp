@@ -0,0 +1,67 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include "deque.hpp"
+#include "exceptions.hpp"
+
+/***************************/
+int N = 20000;
+/***************************/
+
+// tiny nodes, so that nodes come and go and the first node changes often.
+typedef sjtu::deque<int, 4> Deque;
+
+bool check(Deque &q, std::deque<int> &stl){
+	for(int i = 0; i < 20; i++){
+		int a = rand() % (stl.size() + 1), b = rand() % (stl.size() + 1);
+		Deque::iterator x = q.begin() + a, y = q.begin() + b;
+		if(y - x != b - a || x - q.begin() != a || q.end() - y != (long)stl.size() - b) return 0;
+		if(a < (int)stl.size() && *x != stl[a]) return 0;
+	}
+	return 1;
+}
+void test1(){
+	printf("test1: distance after front operations  ");
+	Deque q;
+	std::deque<int> stl;
+	for(int i = 0; i < N; i++){
+		int op = rand() % 4;
+		if(op == 0 || stl.empty()) q.push_front(i), stl.push_front(i);
+		else if(op == 1) q.push_back(i), stl.push_back(i);
+		else if(op == 2) q.pop_front(), stl.pop_front();
+		else q.pop_back(), stl.pop_back();
+		if(!check(q, stl)){puts("Wrong Answer");return;}
+	}
+	puts("Accept");
+}
+void test2(){
+	printf("test2: distance after middle operations ");
+	Deque q;
+	std::deque<int> stl;
+	for(int i = 0; i < N; i++){
+		int op = rand() % 6;
+		if(op == 0 || stl.empty()) q.push_front(i), stl.push_front(i);
+		else if(op == 1) q.push_back(i), stl.push_back(i);
+		else if(op == 2) q.pop_front(), stl.pop_front();
+		else if(op == 3){
+			int pos = rand() % (stl.size() + 1);
+			q.insert(q.begin() + pos, i);
+			stl.insert(stl.begin() + pos, i);
+		}
+		else{
+			int pos = rand() % stl.size();
+			q.erase(q.begin() + pos);
+			stl.erase(stl.begin() + pos);
+		}
+		if(!check(q, stl)){puts("Wrong Answer");return;}
+	}
+	puts("Accept");
+}
+int main(){
+	srand(14);
+	puts("test start:");
+	test1();
+	test2();
+	return 0;
+}
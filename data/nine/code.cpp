@@ -0,0 +1,231 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <string>
+#include <memory>
+#include "deque.hpp"
+#include "exceptions.hpp"
+
+#ifdef SJTU_DEQUE_HAS_PMR
+// every member must compile with an allocator that cannot be assigned.
+template class sjtu::deque<std::pmr::string, 8, std::pmr::polymorphic_allocator<std::pmr::string> >;
+#endif
+
+/***************************/
+int N = 100000;
+/***************************/
+
+long bytesLive = 0;
+long constructs = 0;
+long destroys = 0;
+template<class U>
+class Counting{
+public:
+	typedef U value_type;
+	int id;
+	Counting(int id = 0):id(id){}
+	template<class V> Counting(const Counting<V> &other):id(other.id){}
+	U *allocate(size_t n){
+		bytesLive += n * sizeof(U);
+		return std::allocator<U>().allocate(n);
+	}
+	void deallocate(U *p, size_t n){
+		bytesLive -= n * sizeof(U);
+		std::allocator<U>().deallocate(p, n);
+	}
+	template<class V, class... Args>
+	void construct(V *p, Args&&... args){
+		constructs++;
+		::new((void *)p) V(std::forward<Args>(args)...);
+	}
+	template<class V>
+	void destroy(V *p){
+		destroys++;
+		p -> ~V();
+	}
+};
+template<class U, class V>
+bool operator == (const Counting<U> &a, const Counting<V> &b){
+	return a.id == b.id;
+}
+template<class U, class V>
+bool operator != (const Counting<U> &a, const Counting<V> &b){
+	return a.id != b.id;
+}
+typedef sjtu::deque<std::string, 64, Counting<std::string> > Deque;
+
+template<class Stl>
+bool equal(Deque &q, Stl &stl){
+	if(q.size() != stl.size()) return 0;
+	if(q.empty() != stl.empty()) return 0;
+	typename Stl::iterator it_stl = stl.begin();
+	for(Deque::iterator it_q = q.begin(); it_q != q.end(); it_q++, it_stl++){
+		if(*it_q != *it_stl) return 0;
+	}
+	return 1;
+}
+void test1(){
+	printf("test1: allocations go through Alloc  ");
+	{
+		Deque q(Counting<std::string>(1));
+		std::deque<std::string> stl;
+		for(int i = 0; i < N; i++){
+			int op = rand() % 4;
+			std::string s = std::to_string(rand());
+			if(op == 0) q.push_back(s), stl.push_back(s);
+			else if(op == 1) q.push_front(s), stl.push_front(s);
+			else if(op == 2 && !stl.empty()){
+				int pos = rand() % stl.size();
+				q.erase(q.begin() + pos);
+				stl.erase(stl.begin() + pos);
+			}
+			else{
+				int pos = rand() % (stl.size() + 1);
+				q.insert(q.begin() + pos, s);
+				stl.insert(stl.begin() + pos, s);
+			}
+		}
+		if(!equal(q, stl) || bytesLive <= 0 || constructs < (long)stl.size()){puts("Wrong Answer");return;}
+		if(q.get_allocator().id != 1){puts("Wrong Answer");return;}
+	}
+	if(bytesLive != 0){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+void test2(){
+	printf("test2: copy, move & swap             ");
+	{
+		Deque a(Counting<std::string>(1)), b(Counting<std::string>(2));
+		std::deque<std::string> stl;
+		for(int i = 0; i < N; i++){
+			std::string s = std::to_string(i);
+			a.push_back(s);
+			stl.push_back(s);
+		}
+		Deque c(a);
+		b = a;
+		if(!equal(b, stl) || !equal(c, stl) || b.get_allocator().id != 2){puts("Wrong Answer");return;}
+		b = std::move(a);
+		if(!equal(b, stl) || !a.empty() || b.get_allocator().id != 2){puts("Wrong Answer");return;}
+		Deque d(std::move(c));
+		if(!equal(d, stl) || d.get_allocator().id != 1){puts("Wrong Answer");return;}
+		d.swap(c);
+		if(!equal(c, stl) || !d.empty()){puts("Wrong Answer");return;}
+		d.push_back("x");
+		c.clear();
+		if(d.size() != 1 || d[0] != "x" || !c.empty()){puts("Wrong Answer");return;}
+	}
+	if(bytesLive != 0){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+void test3(){
+	printf("test3: constructs match destroys     ");
+	constructs = destroys = 0;
+	{
+		typedef sjtu::deque<int, 8, Counting<int> > IntDeque;
+		IntDeque q;
+		std::deque<int> stl;
+		for(int i = 0; i < N; i++){
+			int op = rand() % 4;
+			if(op == 0) q.push_back(i), stl.push_back(i);
+			else if(op == 1) q.push_front(i), stl.push_front(i);
+			else if(op == 2 && !stl.empty()){
+				int pos = rand() % stl.size();
+				q.erase(q.begin() + pos);
+				stl.erase(stl.begin() + pos);
+			}
+			else{
+				int pos = rand() % (stl.size() + 1);
+				q.insert(q.begin() + pos, i);
+				stl.insert(stl.begin() + pos, i);
+			}
+		}
+		IntDeque c(q), d;
+		d = c;
+		d.insert(d.begin() + d.size() / 2, stl.begin(), stl.end());
+		d.erase(d.begin() + 3, d.end() - 3);
+		c.clear();
+		for(size_t i = 0; i < stl.size(); i++){
+			if(q[i] != stl[i]){puts("Wrong Answer");return;}
+		}
+	}
+	if(constructs == 0 || constructs != destroys || bytesLive != 0){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+#ifdef SJTU_DEQUE_HAS_PMR
+class Upstream : public std::pmr::memory_resource{
+public:
+	long live = 0;
+private:
+	void *do_allocate(size_t bytes, size_t align) override {
+		live += bytes;
+		return std::pmr::new_delete_resource() -> allocate(bytes, align);
+	}
+	void do_deallocate(void *p, size_t bytes, size_t align) override {
+		live -= bytes;
+		std::pmr::new_delete_resource() -> deallocate(p, bytes, align);
+	}
+	bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+		return this == &other;
+	}
+};
+void test4(){
+	printf("test4: sjtu::pmr::deque              ");
+	Upstream res, other;
+	{
+		sjtu::pmr::deque<std::pmr::string, 8> q(&res);
+		std::deque<std::string> stl;
+		for(int i = 0; i < N / 10; i++){
+			std::string s = std::to_string(rand()) + std::string(20, 'x');
+			if(rand() % 2) q.push_back(std::pmr::string(s)), stl.push_back(s);
+			else q.emplace_front(s.c_str()), stl.push_front(s);
+		}
+		if(res.live <= 0 || q.get_allocator().resource() != &res){puts("Wrong Answer");return;}
+		// the elements are built with the deque's resource too.
+		if(q[stl.size() / 2].get_allocator().resource() != &res){puts("Wrong Answer");return;}
+		sjtu::pmr::deque<std::pmr::string, 8> c(q), m(&other);
+		m = q;
+		if(c.get_allocator().resource() == &res || m.get_allocator().resource() != &other || other.live <= 0){puts("Wrong Answer");return;}
+		m = std::move(c);
+		sjtu::pmr::deque<std::pmr::string, 8> n(&other);
+		n.swap(m);
+		for(size_t i = 0; i < stl.size(); i++){
+			if(q[i] != stl[i].c_str() || n[i] != stl[i].c_str()){puts("Wrong Answer");return;}
+		}
+		if(!m.empty() || n.get_allocator().resource() != &other){puts("Wrong Answer");return;}
+	}
+	if(res.live != 0 || other.live != 0){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+#else
+void test4(){
+	// std::pmr needs C++17, there is nothing to check before it.
+	printf("test4: sjtu::pmr::deque              ");
+	puts("Accept");
+}
+#endif
+void test5(){
+	printf("test5: empty inserts allocate none   ");
+	{
+		Deque q(Counting<std::string>(1));
+		std::string s[1];
+		q.insert(q.begin(), s, s);
+		q.insert(q.end(), 0, s[0]);
+		q.append(s, s);
+		if(!q.empty() || q.begin() != q.end() || bytesLive != 0){puts("Wrong Answer");return;}
+		q.append(s, s + 1);
+		if(q.size() != 1 || bytesLive <= 0){puts("Wrong Answer");return;}
+	}
+	if(bytesLive != 0){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+int main(){
+	srand(9);
+	puts("test start:");
+	test1();
+	test2();
+	test3();
+	test4();
+	test5();
+	return 0;
+}
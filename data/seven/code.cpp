@@ -0,0 +1,151 @@
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <vector>
+#include <string>
+#include <utility>
+#include "deque.hpp"
+#include "exceptions.hpp"
+
+/***************************/
+int N = 100000;
+/***************************/
+
+class T{
+private:
+	std::string s;
+public:
+	T(int x):s(std::to_string(x)){}
+	int num()const {return atoi(s.c_str());}
+};
+bool operator == (const T &a, const T &b){
+	return a.num() == b.num();
+}
+bool operator != (const T &a, const T &b){
+	return a.num() != b.num();
+}
+template<class Deque, class Stl>
+bool equal(Deque &q, Stl &stl){
+	if(q.size() != stl.size()) return 0;
+	if(q.empty() != stl.empty()) return 0;
+	typename Stl::iterator it_stl = stl.begin();
+	for(typename Deque::iterator it_q = q.begin(); it_q != q.end(); it_q++, it_stl++){
+		if(*it_q != *it_stl) return 0;
+	}
+	return 1;
+}
+sjtu::deque<T> make(int n){
+	sjtu::deque<T> q;
+	for(int i = 0; i < n; i++) q.push_back(T(i));
+	return q;
+}
+void test1(){
+	printf("test1: move constructor              ");
+	sjtu::deque<T> a = make(N);
+	std::deque<T> stl;
+	for(int i = 0; i < N; i++) stl.push_back(T(i));
+	sjtu::deque<T> b(std::move(a));
+	if(!equal(b, stl) || !a.empty() || a.size() != 0 || !(a.begin() == a.end())){puts("Wrong Answer");return;}
+	a.push_back(T(1));
+	a.push_front(T(0));
+	if(a.size() != 2 || a[0] != T(0) || a[1] != T(1)){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+void test2(){
+	printf("test2: move assignment               ");
+	sjtu::deque<T> a = make(N), b = make(10);
+	std::deque<T> stl;
+	for(int i = 0; i < N; i++) stl.push_back(T(i));
+	b = std::move(a);
+	if(!equal(b, stl) || !a.empty()){puts("Wrong Answer");return;}
+	b = std::move(b);
+	if(!equal(b, stl)){puts("Wrong Answer");return;}
+	a = make(5);
+	if(a.size() != 5 || a.back() != T(4)){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+void test3(){
+	printf("test3: swap                          ");
+	sjtu::deque<T> a = make(N), b;
+	std::deque<T> sa, sb;
+	for(int i = 0; i < N; i++) sa.push_back(T(i));
+	for(int i = 0; i < 1000; i++){
+		b.insert(b.begin() + rand() % (b.size() + 1), T(i));
+	}
+	for(sjtu::deque<T>::iterator it = b.begin(); it != b.end(); ++it) sb.push_back(*it);
+	a.swap(b);
+	if(!equal(a, sb) || !equal(b, sa)){puts("Wrong Answer");return;}
+	using std::swap;
+	swap(a, b);
+	if(!equal(a, sa) || !equal(b, sb)){puts("Wrong Answer");return;}
+	if(a.end() - a.begin() != N || b.end() - b.begin() != 1000){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+void test4(){
+	printf("test4: container of deques           ");
+	std::vector<sjtu::deque<T> > v;
+	for(int i = 0; i < 1000; i++){
+		v.push_back(make(i % 50));
+	}
+	for(int i = 0; i < 1000; i++){
+		if((int)v[i].size() != i % 50){puts("Wrong Answer");return;}
+		for(int j = 0; j < i % 50; j++){
+			if(v[i][j] != T(j)){puts("Wrong Answer");return;}
+		}
+	}
+	puts("Accept");
+}
+int copies = 0;
+class Heavy{
+private:
+	int a, b;
+public:
+	Heavy(int a, int b):a(a), b(b){}
+	Heavy(const Heavy &other):a(other.a), b(other.b){copies++;}
+	Heavy(Heavy &&other):a(other.a), b(other.b){}
+	Heavy &operator=(const Heavy &other){a = other.a; b = other.b; copies++; return *this;}
+	Heavy &operator=(Heavy &&other){a = other.a; b = other.b; return *this;}
+	int sum()const {return a + b;}
+};
+void test5(){
+	printf("test5: emplace & rvalue push         ");
+	sjtu::deque<Heavy> q;
+	std::deque<int> stl;
+	for(int i = 0; i < N; i++){
+		if(i % 4 == 0) q.emplace_back(i, 1), stl.push_back(i + 1);else
+		if(i % 4 == 1) q.emplace_front(i, 2), stl.push_front(i + 2);else
+		if(i % 4 == 2) q.push_back(Heavy(i, 3)), stl.push_back(i + 3);else
+		q.push_front(Heavy(i, 4)), stl.push_front(i + 4);
+	}
+	for(int i = 0; i < 1000; i++){
+		int pos = rand() % (q.size() + 1);
+		if(i % 2 == 0){
+			sjtu::deque<Heavy>::iterator it = q.emplace(q.begin() + pos, i, 5);
+			if(it -> sum() != i + 5){puts("Wrong Answer");return;}
+		}
+		else{
+			sjtu::deque<Heavy>::iterator it = q.insert(q.begin() + pos, Heavy(i, 6));
+			if(it -> sum() != i + 6){puts("Wrong Answer");return;}
+		}
+		stl.insert(stl.begin() + pos, i + 5 + i % 2);
+	}
+	if(q.emplace_back(7, 7).sum() != 14 || q.emplace_front(8, 8).sum() != 16){puts("Wrong Answer");return;}
+	stl.push_back(14);
+	stl.push_front(16);
+	if(copies != 0 || q.size() != stl.size()){puts("Wrong Answer");return;}
+	for(size_t i = 0; i < stl.size(); i++){
+		if(q[i].sum() != stl[i]){puts("Wrong Answer");return;}
+	}
+	puts("Accept");
+}
+int main(){
+	srand(2333);
+	puts("test start:");
+	test1();//move constructor
+	test2();//move assignment
+	test3();//swap
+	test4();//container of deques
+	test5();//emplace & rvalue push
+}
@@ -0,0 +1,112 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iterator>
+#include "deque.hpp"
+#include "exceptions.hpp"
+
+/***************************/
+int N = 100000;
+/***************************/
+
+template<class Deque, class Stl>
+bool equal(Deque &q, Stl &stl){
+	if(q.size() != stl.size()) return 0;
+	typename Stl::iterator it_stl = stl.begin();
+	for(typename Deque::iterator it_q = q.begin(); it_q != q.end(); it_q++, it_stl++){
+		if(*it_q != *it_stl) return 0;
+	}
+	return 1;
+}
+void test1(){
+	printf("test1: push_back_n                ");
+	sjtu::deque<int, 32> q;
+	std::deque<int> stl;
+	std::vector<int> src(N);
+	for(int i = 0; i < N; i++) src[i] = rand();
+	std::vector<int>::iterator it = src.begin();
+	// n = 0 takes nothing.
+	if(q.push_back_n(it, 0) != src.begin() || !q.empty()){puts("Wrong Answer");return;}
+	while(it != src.end()){
+		size_t n = std::min<size_t>(rand() % 100, src.end() - it);
+		if(rand() % 4 == 0 && !stl.empty()) q.pop_front(), stl.pop_front();
+		std::vector<int>::iterator next = q.push_back_n(it, n);
+		if(next - it != (long)n){puts("Wrong Answer");return;}
+		stl.insert(stl.end(), it, next);
+		it = next;
+	}
+	if(!equal(q, stl)){puts("Wrong Answer");return;}
+	// a single-pass source is read exactly n times.
+	std::istringstream in("1 2 3 4 5 6 7 8 9");
+	std::istream_iterator<int> is(in);
+	sjtu::deque<int, 4> p;
+	is = p.push_back_n(is, 6);
+	if(p.size() != 6 || p[5] != 6 || *is != 7){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+void test2(){
+	printf("test2: pop_front_n                ");
+	sjtu::deque<int, 32> q;
+	std::deque<int> stl;
+	for(int i = 0; i < N; i++){
+		if(rand() % 2) q.push_back(i), stl.push_back(i);
+		else q.push_front(i), stl.push_front(i);
+	}
+	std::vector<int> out(N + 10, -1);
+	int *o = out.data();
+	if(q.pop_front_n(o, 0) != 0 || q.size() != (size_t)N){puts("Wrong Answer");return;}
+	size_t done = 0;
+	while(!stl.empty()){
+		size_t n = rand() % 300;
+		size_t got = q.pop_front_n(o + done, n);
+		if(got != std::min(n, stl.size())){puts("Wrong Answer");return;}
+		for(size_t i = 0; i < got; i++){
+			if(out[done + i] != stl.front()){puts("Wrong Answer");return;}
+			stl.pop_front();
+		}
+		done += got;
+		if(!equal(q, stl)){puts("Wrong Answer");return;}
+	}
+	// asking for more than there is drains the deque and stops.
+	q.push_back(1), q.push_back(2);
+	if(q.pop_front_n(o, 100) != 2 || !q.empty() || out[0] != 1 || out[1] != 2){puts("Wrong Answer");return;}
+	if(q.pop_front_n(o, 5) != 0){puts("Wrong Answer");return;}
+	q.push_back(3);
+	if(q.size() != 1 || q.front() != 3){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+void test3(){
+	printf("test3: strings, several nodes     ");
+	sjtu::deque<std::string, 8> q;
+	std::deque<std::string> stl;
+	std::vector<std::string> src;
+	for(int i = 0; i < 1000; i++) src.push_back(std::to_string(rand()) + std::string(rand() % 40, 'y'));
+	for(int round = 0; round < 50; round++){
+		size_t n = rand() % 60;
+		size_t from = rand() % (src.size() - n);
+		q.push_back_n(src.begin() + from, n);
+		stl.insert(stl.end(), src.begin() + from, src.begin() + from + n);
+		std::vector<std::string> out;
+		size_t m = rand() % 70;
+		size_t got = q.pop_front_n(std::back_inserter(out), m);
+		if(got != out.size() || got != std::min(m, stl.size())){puts("Wrong Answer");return;}
+		for(size_t i = 0; i < got; i++){
+			if(out[i] != stl.front()){puts("Wrong Answer");return;}
+			stl.pop_front();
+		}
+		if(!equal(q, stl)){puts("Wrong Answer");return;}
+	}
+	puts("Accept");
+}
+int main(){
+	srand(17);
+	puts("test start:");
+	test1();
+	test2();
+	test3();
+	return 0;
+}
@@ -0,0 +1,116 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include "deque.hpp"
+#include "exceptions.hpp"
+
+/***************************/
+int N = 100000;
+/***************************/
+
+typedef std::unique_ptr<int> Ptr;
+
+void test1(){
+	printf("test1: try_ on an empty deque     ");
+	sjtu::deque<int> q;
+	const sjtu::deque<int> &c = q;
+	int x = 42;
+	if(q.try_pop_front(x) || q.try_pop_back(x) || x != 42){puts("Wrong Answer");return;}
+	if(q.try_front() != NULL || q.try_back() != NULL || c.try_front() != NULL || c.try_back() != NULL){puts("Wrong Answer");return;}
+	if(!q.empty() || q.size() != 0 || q.begin() != q.end()){puts("Wrong Answer");return;}
+	// drained to empty, the deque must look exactly like a fresh one.
+	q.push_back(1);
+	q.push_front(0);
+	if(!q.try_pop_back(x) || x != 1 || !q.try_pop_back(x) || x != 0 || q.try_pop_front(x) || x != 0){puts("Wrong Answer");return;}
+	if(!q.empty() || q.try_front() != NULL){puts("Wrong Answer");return;}
+	q.push_back(7);
+	if(q.size() != 1 || q.front() != 7 || *q.try_back() != 7){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+void test2(){
+	printf("test2: try_ against std::deque    ");
+	sjtu::deque<int> q;
+	std::deque<int> stl;
+	for(int i = 0; i < N; i++){
+		int op = rand() % 6;
+		int x = -1, y = -1;
+		bool a = false, b = false;
+		if(op == 0) q.push_back(i), stl.push_back(i);
+		else if(op == 1) q.push_front(i), stl.push_front(i);
+		else if(op == 2){
+			a = q.try_pop_front(x);
+			if((b = !stl.empty())) y = stl.front(), stl.pop_front();
+		}
+		else if(op == 3){
+			a = q.try_pop_back(x);
+			if((b = !stl.empty())) y = stl.back(), stl.pop_back();
+		}
+		else if(op == 4){
+			const int *p = q.try_front();
+			if((p != NULL) != !stl.empty() || (p != NULL && *p != stl.front())){puts("Wrong Answer");return;}
+		}
+		else{
+			int *p = q.try_back();
+			if((p != NULL) != !stl.empty() || (p != NULL && *p != stl.back())){puts("Wrong Answer");return;}
+		}
+		if(a != b || x != y || q.size() != stl.size()){puts("Wrong Answer");return;}
+	}
+	for(size_t i = 0; i < stl.size(); i++){
+		if(q[i] != stl[i]){puts("Wrong Answer");return;}
+	}
+	puts("Accept");
+}
+void test3(){
+	printf("test3: pop_*_value                ");
+	sjtu::deque<int> q;
+	for(int i = 0; i < 100; i++) q.push_back(i);
+	for(int i = 0; i < 50; i++){
+		if(q.pop_front_value() != i || q.pop_back_value() != 99 - i){puts("Wrong Answer");return;}
+	}
+	bool thrown = false;
+	try{
+		q.pop_front_value();
+	}
+	catch(sjtu::container_is_empty &){
+		thrown = true;
+	}
+	if(!thrown || !q.empty()){puts("Wrong Answer");return;}
+	thrown = false;
+	try{
+		q.pop_back_value();
+	}
+	catch(sjtu::container_is_empty &){
+		thrown = true;
+	}
+	if(!thrown || !q.empty()){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+void test4(){
+	printf("test4: move-only elements         ");
+	sjtu::deque<Ptr> q;
+	for(int i = 0; i < N; i++){
+		if(i % 2) q.push_back(Ptr(new int(i)));
+		else q.push_front(Ptr(new int(i)));
+	}
+	Ptr p;
+	if(!q.try_pop_front(p) || *p != N - 2 || !q.try_pop_back(p) || *p != N - 1){puts("Wrong Answer");return;}
+	Ptr v = q.pop_front_value();
+	Ptr w = q.pop_back_value();
+	if(*v != N - 4 || *w != N - 3 || **q.try_front() != N - 6 || **q.try_back() != N - 5){puts("Wrong Answer");return;}
+	while(q.try_pop_back(p)){
+		if(p == NULL){puts("Wrong Answer");return;}
+	}
+	if(!q.empty() || q.try_pop_front(p) || *p != N - 6){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+int main(){
+	srand(16);
+	puts("test start:");
+	test1();
+	test2();
+	test3();
+	test4();
+	return 0;
+}
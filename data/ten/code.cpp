@@ -0,0 +1,125 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <vector>
+#include "deque.hpp"
+#include "exceptions.hpp"
+
+/***************************/
+int N = 100000;
+/***************************/
+
+template<class Deque, class Stl>
+bool equal(Deque &q, Stl &stl){
+	if(q.size() != stl.size()) return 0;
+	typename Stl::iterator it_stl = stl.begin();
+	for(typename Deque::iterator it_q = q.begin(); it_q != q.end(); it_q++, it_stl++){
+		if(*it_q != *it_stl) return 0;
+	}
+	return 1;
+}
+void build(sjtu::deque<int> &q, std::deque<int> &stl){
+	for(int i = 0; i < N; i++){
+		int v = rand() % N;
+		int op = rand() % 3;
+		if(op == 0) q.push_back(v), stl.push_back(v);
+		else if(op == 1) q.push_front(v), stl.push_front(v);
+		else{
+			int pos = rand() % (stl.size() + 1);
+			q.insert(q.begin() + pos, v);
+			stl.insert(stl.begin() + pos, v);
+		}
+	}
+}
+void test1(){
+	printf("test1: iterator traits               ");
+	typedef std::iterator_traits<sjtu::deque<int>::iterator> traits;
+	typedef std::iterator_traits<sjtu::deque<int>::const_iterator> ctraits;
+	bool ok = std::is_same<traits::iterator_category, std::random_access_iterator_tag>::value
+		&& std::is_same<ctraits::iterator_category, std::random_access_iterator_tag>::value
+		&& std::is_same<traits::value_type, int>::value
+		&& std::is_same<traits::reference, int &>::value
+		&& std::is_same<ctraits::reference, const int &>::value
+		&& std::is_signed<traits::difference_type>::value;
+	if(!ok){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+void test2(){
+	printf("test2: comparison & subscript        ");
+	sjtu::deque<int> q;
+	std::deque<int> stl;
+	build(q, stl);
+	for(int i = 0; i < 1000; i++){
+		int a = rand() % N, b = rand() % N;
+		sjtu::deque<int>::iterator x = q.begin() + a, y = q.begin() + b;
+		if((x < y) != (a < b) || (x <= y) != (a <= b) || (x > y) != (a > b) || (x >= y) != (a >= b)){puts("Wrong Answer");return;}
+		if(x[b - a] != stl[b] || q.cbegin()[a] != stl[a]){puts("Wrong Answer");return;}
+		if(!((a + q.begin()) == x)){puts("Wrong Answer");return;}
+	}
+	puts("Accept");
+}
+void test3(){
+	printf("test3: std::sort & std::lower_bound  ");
+	sjtu::deque<int> q;
+	std::deque<int> stl;
+	build(q, stl);
+	std::sort(q.begin(), q.end());
+	std::sort(stl.begin(), stl.end());
+	if(!equal(q, stl)){puts("Wrong Answer");return;}
+	for(int i = 0; i < 1000; i++){
+		int v = rand() % N;
+		sjtu::deque<int>::const_iterator it = std::lower_bound(q.cbegin(), q.cend(), v);
+		if(std::distance(q.cbegin(), it) != std::lower_bound(stl.begin(), stl.end(), v) - stl.begin()){puts("Wrong Answer");return;}
+	}
+	puts("Accept");
+}
+void test4(){
+	printf("test4: other std algorithms          ");
+	sjtu::deque<int> q;
+	std::deque<int> stl;
+	build(q, stl);
+	std::reverse(q.begin(), q.end());
+	std::reverse(stl.begin(), stl.end());
+	std::rotate(q.begin(), q.begin() + N / 3, q.end());
+	std::rotate(stl.begin(), stl.begin() + N / 3, stl.end());
+	if(!equal(q, stl)){puts("Wrong Answer");return;}
+	std::nth_element(q.begin(), q.begin() + N / 2, q.end());
+	std::nth_element(stl.begin(), stl.begin() + N / 2, stl.end());
+	if(q[N / 2] != stl[N / 2]){puts("Wrong Answer");return;}
+	if(std::accumulate(q.cbegin(), q.cend(), 0LL) != std::accumulate(stl.begin(), stl.end(), 0LL)){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+void test5(){
+	printf("test5: unqualified std algorithms    ");
+	using namespace std;
+	sjtu::deque<int> q;
+	std::deque<int> stl;
+	build(q, stl);
+	// argument-dependent lookup must not drag in anything that competes with std.
+	sjtu::deque<int>::iterator it = find(q.begin(), q.end(), stl[N / 2]);
+	if(it - q.begin() != find(stl.begin(), stl.end(), stl[N / 2]) - stl.begin()){puts("Wrong Answer");return;}
+	if(count(q.cbegin(), q.cend(), stl[0]) != count(stl.begin(), stl.end(), stl[0])){puts("Wrong Answer");return;}
+	vector<int> out(N);
+	copy(q.begin(), q.end(), out.begin());
+	fill(q.begin(), q.begin() + 10, -1);
+	transform(q.cbegin(), q.cend(), q.begin(), [](int x){ return x + 1; });
+	for_each(q.begin(), q.end(), [](int &x){ x *= 2; });
+	if(!std::equal(out.begin() + 10, out.end(), stl.begin() + 10) || accumulate(q.cbegin(), q.cbegin() + 10, 0) != 0){puts("Wrong Answer");return;}
+	if(!equal(q.begin() + 10, q.end(), out.begin() + 10, [](int a, int b){ return a == (b + 1) * 2; })){puts("Wrong Answer");return;}
+	if(*min_element(q.cbegin(), q.cend()) != 0 || max_element(q.begin(), q.end()) - q.begin() != max_element(stl.begin() + 10, stl.end()) - stl.begin()){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+int main(){
+	srand(10);
+	puts("test start:");
+	test1();
+	test2();
+	test3();
+	test4();
+	test5();
+	return 0;
+}
@@ -0,0 +1,112 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <vector>
+#include <atomic>
+#include <stdexcept>
+#include <algorithm>
+#include "deque.hpp"
+#include "exceptions.hpp"
+
+/***************************/
+int N = 1000000;
+/***************************/
+
+void build(sjtu::deque<long long> &q, std::deque<long long> &stl){
+	for(int i = 0; i < N; i++){
+		long long v = rand() % 1000;
+		if(rand() % 2) q.push_back(v), stl.push_back(v);
+		else q.push_front(v), stl.push_front(v);
+	}
+	for(int i = 0; i < 1000; i++){
+		int pos = rand() % stl.size();
+		q.insert(q.begin() + pos, i);
+		stl.insert(stl.begin() + pos, i);
+	}
+}
+void test1(){
+	printf("test1: parallel for_each   ");
+	sjtu::deque<long long> q;
+	std::deque<long long> stl;
+	build(q, stl);
+	sjtu::parallel::for_each(q.begin(), q.end(), [](long long &x){ x = x * 3 + 1; });
+	std::atomic<long long> total(0);
+	sjtu::parallel::for_each(q.cbegin() + 7, q.cend() - 11, [&total](const long long &x){ total += x; });
+	long long s = 0;
+	for(size_t i = 0; i < stl.size(); i++){
+		if(q[i] != stl[i] * 3 + 1){puts("Wrong Answer");return;}
+		if(i >= 7 && i + 11 < stl.size()) s += q[i];
+	}
+	if(s != total){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+void test2(){
+	printf("test2: parallel transform  ");
+	sjtu::deque<long long> q;
+	std::deque<long long> stl;
+	build(q, stl);
+	std::vector<long long> out(stl.size());
+	if(sjtu::parallel::transform(q.cbegin(), q.cend(), out.begin(), [](long long x){ return x * x; }) != out.end()){puts("Wrong Answer");return;}
+	sjtu::deque<long long> p(q);
+	sjtu::parallel::transform(q.begin() + 5, q.end(), p.begin(), [](long long x){ return -x; });
+	for(size_t i = 0; i < stl.size(); i++){
+		if(out[i] != stl[i] * stl[i]){puts("Wrong Answer");return;}
+		if(i + 5 < stl.size() && p[i] != -stl[i + 5]){puts("Wrong Answer");return;}
+	}
+	puts("Accept");
+}
+void test3(){
+	printf("test3: parallel reduce     ");
+	sjtu::deque<long long> q;
+	std::deque<long long> stl;
+	build(q, stl);
+	long long s = 0;
+	for(size_t i = 0; i < stl.size(); i++) s += stl[i];
+	if(sjtu::parallel::reduce(q.begin(), q.end(), 10LL) != s + 10){puts("Wrong Answer");return;}
+	if(sjtu::parallel::reduce(q.cbegin(), q.cend(), -1LL, [](long long a, long long b){ return std::max(a, b); }) != *std::max_element(stl.begin(), stl.end())){puts("Wrong Answer");return;}
+	sjtu::deque<long long> e;
+	if(sjtu::parallel::reduce(e.begin(), e.end(), 42LL) != 42){puts("Wrong Answer");return;}
+	// the same range folds the same way whatever the pool.
+	sjtu::deque<double> d;
+	for(int i = 0; i < N; i++) d.push_back(1.0 / (i + 1));
+	sjtu::parallel::thread_pool one(1), many(8);
+	double a = sjtu::parallel::reduce(one, d.begin(), d.end(), 0.0, [](double x, double y){ return x + y; });
+	double b = sjtu::parallel::reduce(many, d.begin(), d.end(), 0.0, [](double x, double y){ return x + y; });
+	if(a != b){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+void test4(){
+	printf("test4: nesting & exceptions");
+	sjtu::deque<long long> q;
+	std::deque<long long> stl;
+	build(q, stl);
+	sjtu::parallel::thread_pool pool(3);
+	std::atomic<long long> total(0);
+	sjtu::deque<int> outer;
+	for(int i = 0; i < 2000; i++) outer.push_back(i);
+	sjtu::parallel::for_each(pool, outer.begin(), outer.end(), [&](int i){
+		if(i % 500 == 0) total += sjtu::parallel::reduce(pool, q.begin(), q.end(), 0LL, [](long long x, long long y){ return x + y; });
+	});
+	long long s = 0;
+	for(size_t i = 0; i < stl.size(); i++) s += stl[i];
+	if(total != s * 4){puts("Wrong Answer");return;}
+	bool thrown = false;
+	try{
+		sjtu::parallel::for_each(pool, q.begin(), q.end(), [](long long x){ if(x == 999) throw std::runtime_error("x"); });
+	}
+	catch(std::runtime_error &){
+		thrown = true;
+	}
+	if(!thrown){puts("Wrong Answer");return;}
+	puts(" Accept");
+}
+int main(){
+	srand(13);
+	puts("test start:");
+	test1();
+	test2();
+	test3();
+	test4();
+	return 0;
+}
@@ -0,0 +1,105 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <deque>
+#include <vector>
+#include <algorithm>
+#include "deque.hpp"
+#include "exceptions.hpp"
+
+/***************************/
+int N = 100000;
+/***************************/
+
+template<class T>
+void build(sjtu::deque<T> &q, std::deque<T> &stl, int range){
+	for(int i = 0; i < N; i++){
+		T v = T(rand() % range - range / 2);
+		int op = rand() % 3;
+		if(op == 0) q.push_back(v), stl.push_back(v);
+		else if(op == 1) q.push_front(v), stl.push_front(v);
+		else{
+			int pos = rand() % (stl.size() + 1);
+			q.insert(q.begin() + pos, v);
+			stl.insert(stl.begin() + pos, v);
+		}
+	}
+}
+// every level the cpu offers must give the std answer.
+template<class T>
+bool check(sjtu::deque<T> &q, std::deque<T> &stl){
+	bool ok = true;
+	for(int lv = sjtu::simd::level_scalar; lv <= sjtu::simd::level_avx2; lv++){
+		sjtu::simd::set_level(lv);
+		for(int i = 0; i < 50 && ok; i++){
+			int l = rand() % (stl.size() + 1), r = rand() % (stl.size() + 1);
+			if(l > r) std::swap(l, r);
+			T v = stl.empty() ? T(0) : stl[rand() % stl.size()];
+			typename sjtu::deque<T>::const_iterator b = q.cbegin() + l, e = q.cbegin() + r;
+			if(sjtu::segmented::find(b, e, v) - q.cbegin() != std::find(stl.begin() + l, stl.begin() + r, v) - stl.begin()) ok = false;
+			if(sjtu::segmented::count(b, e, v) != std::count(stl.begin() + l, stl.begin() + r, v)) ok = false;
+			if(sjtu::segmented::min_element(b, e) - q.cbegin() != std::min_element(stl.begin() + l, stl.begin() + r) - stl.begin()) ok = false;
+			if(sjtu::segmented::max_element(b, e) - q.cbegin() != std::max_element(stl.begin() + l, stl.begin() + r) - stl.begin()) ok = false;
+		}
+	}
+	sjtu::simd::set_level(sjtu::simd::level_avx2);
+	return ok;
+}
+void test1(){
+	printf("test1: int kernels        ");
+	sjtu::deque<int> q;
+	std::deque<int> stl;
+	build(q, stl, 2000000000);
+	if(!check(q, stl)){puts("Wrong Answer");return;}
+	long long s = 0;
+	for(size_t i = 0; i < stl.size(); i++) s += stl[i];
+	if(sjtu::segmented::sum(q.begin(), q.end()) != s){puts("Wrong Answer");return;}
+	if(*sjtu::segmented::min_element(q.begin(), q.end()) != *std::min_element(stl.begin(), stl.end())){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+void test2(){
+	printf("test2: double kernels     ");
+	sjtu::deque<double> q;
+	std::deque<double> stl;
+	build(q, stl, 1000);
+	if(!check(q, stl)){puts("Wrong Answer");return;}
+	for(int i = 0; i < 20; i++){
+		int pos = rand() % stl.size();
+		q[pos] = stl[pos] = NAN;
+		q[pos / 2] = stl[pos / 2] = (i & 1) ? 0.0 : -0.0;
+	}
+	if(!check(q, stl)){puts("Wrong Answer");return;}
+	q.clear(), stl.clear();
+	build(q, stl, 1000);
+	double s = 0;
+	for(size_t i = 0; i < stl.size(); i++) s += stl[i];
+	if(sjtu::segmented::sum(q.begin(), q.end()) != s){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+void test3(){
+	printf("test3: float & others     ");
+	sjtu::deque<float> q;
+	std::deque<float> stl;
+	build(q, stl, 100);
+	q.push_front(NAN), stl.push_front(NAN);
+	if(!check(q, stl)){puts("Wrong Answer");return;}
+	sjtu::deque<short> p;
+	std::deque<short> ps;
+	build(p, ps, 100);
+	if(!check(p, ps)){puts("Wrong Answer");return;}
+	std::vector<int> vec(1000);
+	for(int i = 0; i < 1000; i++) vec[i] = rand() % 100;
+	if(*sjtu::simd::max_element(vec.data(), vec.data() + vec.size()) != *std::max_element(vec.begin(), vec.end())){puts("Wrong Answer");return;}
+	if(sjtu::simd::count(vec.data(), vec.data() + vec.size(), 42) != (size_t)std::count(vec.begin(), vec.end(), 42)){puts("Wrong Answer");return;}
+	if(sjtu::segmented::sum(vec.begin(), vec.end()) != sjtu::simd::sum(vec.data(), vec.data() + vec.size())){puts("Wrong Answer");return;}
+	puts("Accept");
+}
+int main(){
+	srand(12);
+	puts("test start:");
+	test1();
+	test2();
+	test3();
+	return 0;
+}
@@ -3,33 +3,274 @@
 
 #include "exceptions.hpp"
 
+#include <algorithm>
 #include <cstddef>
+#include <cstring>
 #include <memory>
+#include <new>
+#include <utility>
+#include <type_traits>
 #include <iostream>
-
-const int nodeN = 1000;
+#include <iterator>
+#include <numeric>
+#include <cassert>
+#include <atomic>
+#ifndef SJTU_DEQUE_NO_THREADS
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+#if !defined(SJTU_DEQUE_NO_SIMD) && defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define SJTU_DEQUE_SIMD_X86 1
+#endif
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define SJTU_DEQUE_HAS_PMR 1
+#endif
+#endif
 
 namespace sjtu {
+    /**
+     * default number of elements per node of deque<T>:
+     * about 4 KiB of payload, but never less than 16 elements.
+     */
     template<class T>
+    struct deque_block_size{
+        static const int value = (sizeof(T) * 16 < 4096) ? int(4096 / sizeof(T)) : 16;
+    };
+
+    /**
+     * what a deque does when a precondition of element or iterator access is broken:
+     * checked throws the matching exception, debug_checked asserts (and so vanishes
+     * under NDEBUG), unchecked trusts the caller so that access compiles to plain loads.
+     * at() checks under every policy, as do insert and erase.
+     */
+    struct checked{
+        template<class E>
+        static void require(bool ok){
+            if(!ok){
+                throw E();
+            }
+        }
+    };
+    struct debug_checked{
+        template<class E>
+        static void require(bool ok){
+            assert(ok);
+            (void)ok;
+        }
+    };
+    struct unchecked{
+        template<class E>
+        static void require(bool){}
+    };
+
+    /**
+     * every allocation - nodes, their slot buffers, the map and the counted index -
+     * and every element construction goes through Allocator and std::allocator_traits.
+     */
+    template<class T, int nodeN = deque_block_size<T>::value, class Allocator = std::allocator<T>, class CheckPolicy = checked>
     class deque{
+        static_assert(nodeN > 0, "a deque node must hold at least one element");
+        static_assert(std::is_same<typename Allocator::value_type, T>::value, "Allocator::value_type must be T");
     public:
+        typedef T value_type;
+        typedef size_t size_type;
+        typedef long int difference_type;
+        typedef T &reference;
+        typedef const T &const_reference;
+        typedef T *pointer;
+        typedef const T *const_pointer;
+        typedef Allocator allocator_type;
+        typedef std::allocator_traits<Allocator> allocTraits;
+        /**
+         * a node owns a raw buffer of nodeN slots, elements live inline
+         * and are built through the allocator.
+         * the buffer is used as a ring: logical slot i is stored at
+         * arr[(start + i) % nodeN], logical slots [0, curLength) are alive.
+         */
         struct nodeT{
+            typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type slotT;
+            typedef typename allocTraits::template rebind_alloc<slotT> slotAlloc;
+            typedef typename allocTraits::template rebind_traits<slotT> slotTraits;
             nodeT *prev;
             nodeT *next;
-            T **arr;
+            slotT *arr;
+            int start;
             int curLength;
-            nodeT(){
-                arr = new T*[nodeN];
+            size_t idx;
+            // cached position of logical slot 0, valid while baseEpoch == the deque's epoch.
+            // atomic because const lookups fill it in, possibly from several threads at once.
+            std::atomic<long> base;
+            std::atomic<size_t> baseEpoch;
+            // a copy of the deque's allocator, for the elements and the buffer.
+            Allocator alloc;
+            explicit nodeT(const Allocator &a) : alloc(a) {
+                slotAlloc sa(alloc);
+                arr = slotTraits::allocate(sa, nodeN);
+                start = 0;
+                idx = 0;
+                base.store(0, std::memory_order_relaxed);
+                baseEpoch.store(0, std::memory_order_relaxed);
                 prev = NULL;
                 next = NULL;
                 curLength = 0;
             }
             ~nodeT(){
+                clear();
+                slotAlloc sa(alloc);
+                slotTraits::deallocate(sa, arr, nodeN);
+            }
+            /**
+             * destroy every element. with trivially destructible elements and the
+             * default allocator there is nothing to run, so the slots are just dropped.
+             */
+            void clear(){
+                dropFront(curLength);
+                start = 0;
+            }
+            /**
+             * destroy the first cnt elements and drop their slots.
+             */
+            void dropFront(int cnt){
+                int i;
+                if(!std::is_trivially_destructible<T>::value || !std::is_same<Allocator, std::allocator<T> >::value){
+                    for(i = 0; i < cnt; i++){
+                        destroy(i);
+                    }
+                }
+                start = (start + cnt) % nodeN;
+                curLength -= cnt;
+            }
+            // the buffer index of logical slot i, i must lie in [0, 2 * nodeN - start).
+            int phys(int i) const {
+                i += start;
+                if(i >= nodeN){
+                    i -= nodeN;
+                }
+                return i;
+            }
+            T *ptr(int i){
+                return reinterpret_cast<T *>(arr + phys(i));
+            }
+            template<class... Args>
+            void construct(int i, Args&&... args){
+                allocTraits::construct(alloc, ptr(i), std::forward<Args>(args)...);
+            }
+            void destroy(int i){
+                allocTraits::destroy(alloc, ptr(i));
+            }
+            // move the element in slot from into the empty slot to.
+            void relocate(int to, int from){
+                relocate(to, this, from);
+            }
+            void relocate(int to, nodeT *src, int from){
+                allocTraits::construct(alloc, ptr(to), std::move(*(src -> ptr(from))));
+                src -> destroy(from);
+            }
+            /**
+             * move the n elements in logical slots [from, from + n) of src into the
+             * empty slots [to, to + n) of this node, the ranges may overlap if src == this.
+             * trivially copyable elements are moved with one memmove per contiguous
+             * run of the two rings, anything else one by one in a safe order.
+             * a custom allocator sees every element constructed and destroyed, so it
+             * always gets the one by one path.
+             */
+            void relocate(int to, nodeT *src, int from, int n){
                 int i;
-                for(i  = 0; i < curLength; i++){
-                    delete arr[i];
+                int c;
+                bool forward = (src != this || to <= from);
+                if(std::is_trivially_copyable<T>::value && std::is_same<Allocator, std::allocator<T> >::value){
+                    while(n > 0){
+                        if(forward){
+                            int t = phys(to);
+                            int f = src -> phys(from);
+                            c = std::min(n, std::min(nodeN - t, nodeN - f));
+                            std::memmove(arr + t, src -> arr + f, c * sizeof(slotT));
+                            to += c;
+                            from += c;
+                        }
+                        else{
+                            int t = phys(to + n - 1);
+                            int f = src -> phys(from + n - 1);
+                            c = std::min(n, std::min(t + 1, f + 1));
+                            std::memmove(arr + t - c + 1, src -> arr + f - c + 1, c * sizeof(slotT));
+                        }
+                        n -= c;
+                    }
+                }
+                else if(forward){
+                    for(i = 0; i < n; i++){
+                        relocate(to + i, src, from + i);
+                    }
+                }
+                else{
+                    for(i = n - 1; i >= 0; i--){
+                        relocate(to + i, src, from + i);
+                    }
+                }
+            }
+            /**
+             * make logical slot k an empty slot, the node must not be full.
+             * the shorter side is shifted, so k == 0 only moves start.
+             */
+            void openSlot(int k){
+                if(k < curLength - k){
+                    start = (start == 0 ? nodeN - 1 : start - 1);
+                    relocate(0, this, 1, k);
+                }
+                else{
+                    relocate(k + 1, this, k, curLength - k);
+                }
+                curLength++;
+            }
+            /**
+             * construct an element from args in the free slot in front of logical slot 0
+             * and make it slot 0, the node must not be full. nothing changes if it throws.
+             */
+            template<class... Args>
+            void constructFront(Args&&... args){
+                int s = (start == 0 ? nodeN - 1 : start - 1);
+                allocTraits::construct(alloc, reinterpret_cast<T *>(arr + s), std::forward<Args>(args)...);
+                start = s;
+                curLength++;
+            }
+            /**
+             * remove the already destroyed logical slots [k, k + n).
+             * the shorter side is shifted, so k == 0 only moves start.
+             */
+            void closeSlot(int k, int n = 1){
+                if(k < curLength - n - k){
+                    relocate(n, this, 0, k);
+                    start = (start + n) % nodeN;
                 }
-                delete []arr;
+                else{
+                    relocate(k, this, k + n, curLength - n - k);
+                }
+                curLength -= n;
+            }
+            /**
+             * move the first cnt elements of src to the back of this node.
+             */
+            void appendFrom(nodeT *src, int cnt){
+                relocate(curLength, src, 0, cnt);
+                curLength += cnt;
+                src -> start = (src -> start + cnt) % nodeN;
+                src -> curLength -= cnt;
+            }
+            /**
+             * move the last cnt elements of src to the front of this node.
+             */
+            void prependFrom(nodeT *src, int cnt){
+                start = (start + nodeN - cnt) % nodeN;
+                relocate(0, src, src -> curLength - cnt, cnt);
+                curLength += cnt;
+                src -> curLength -= cnt;
             }
         };
         
@@ -38,6 +279,16 @@ namespace sjtu {
             friend class deque;
             friend class const_iterator;
         public:     
+            typedef std::random_access_iterator_tag iterator_category;
+#if __cplusplus > 201703L
+            typedef std::random_access_iterator_tag iterator_concept;
+#endif
+            typedef T value_type;
+            typedef long int difference_type;
+            typedef T *pointer;
+            typedef T &reference;
+            // marks a deque iterator, see deque::segmentWalk.
+            typedef deque segmented_deque;
             nodeT *node;
             int curPo;
             deque *deqId;
@@ -52,12 +303,6 @@ namespace sjtu {
                 curPo = c;
                 deqId = deq;
             }
-            iterator(const const_iterator &other) {
-                node = other.node;
-                curPo = other.curPo;
-                deqId = other.deqId;
-            }
-
             iterator(const iterator &other){
                 node = other.node;
                 curPo = other.curPo;
@@ -94,33 +339,11 @@ namespace sjtu {
             // if these two iterators points to different vectors, throw invaild_iterator.
             
             long int operator-(const iterator &rhs) const {
-                if(deqId != rhs.deqId){
-                    throw invalid_iterator();
-                }
+                CheckPolicy::template require<invalid_iterator>(deqId == rhs.deqId);
                 if(node == rhs.node){
                     return curPo - rhs.curPo;
                 }
-                nodeT *tmpNode = node -> next;
-                long int dist = node -> curLength - curPo;
-                while(tmpNode != NULL && tmpNode != rhs.node){
-                    dist = dist + tmpNode -> curLength;
-                    tmpNode = tmpNode -> next;
-                }
-                if(tmpNode != NULL){
-                    dist = (dist + rhs.curPo);
-                    return -dist;
-                }
-                dist = rhs.node -> curLength - (rhs.curPo);
-                tmpNode = rhs.node -> next;
-                while(tmpNode != NULL && tmpNode != node){
-                    dist = dist + tmpNode -> curLength;
-                    tmpNode = tmpNode -> next;
-                }
-                if(tmpNode != NULL){
-                    dist = (dist + (curPo));
-                    return dist;
-                }
-                throw runtime_error();
+                return (long int)(deqId -> nodeBase(node) + curPo) - (long int)(deqId -> nodeBase(rhs.node) + rhs.curPo);
             }
             
             iterator& operator+=(const long int &n) {
@@ -128,19 +351,12 @@ namespace sjtu {
                     *this -= -n;
                     return *this;
                 }
-                if(node -> curLength == 0 || n == 0){
+                if(node == NULL || node -> curLength == 0 || n == 0){
                     return *this;
                 }
-                long int diff = n;
-                while(node -> next != NULL && diff >= node -> curLength  - curPo){
-                    diff = diff - (node -> curLength  - curPo);
-                    setNode(node -> next);
-                    curPo = 0;
-                }
-                if(diff > node -> curLength  - curPo){
-                    throw index_out_of_bound();
-                }
-                curPo += diff;
+                long int dest = deqId -> nodeBase(node) + curPo + n;
+                CheckPolicy::template require<index_out_of_bound>(dest <= (long int)deqId -> sizeDeq);
+                setNode(deqId -> locate(dest, curPo));
                 return *this;
             }
             
@@ -149,21 +365,13 @@ namespace sjtu {
                     *this += -n;
                     return *this;
                 }
-                if(node -> curLength == 0 || n == 0){
+                if(node == NULL || node -> curLength == 0 || n == 0){
                     return *this;
                 }
-                long int diff = n;
-                while(node -> prev -> prev != NULL && diff > curPo){
-                    diff = diff - (curPo + 1);
-                    setNode(node -> prev);
-                    curPo = node -> curLength - 1;
-                }
-                if(node -> prev -> prev == NULL && diff > curPo){
-                    throw index_out_of_bound();
-                }
-                curPo -= diff;
+                long int dest = deqId -> nodeBase(node) + curPo - n;
+                CheckPolicy::template require<index_out_of_bound>(dest >= 0);
+                setNode(deqId -> locate(dest, curPo));
                 return *this;
-
             }
             /**
              * TODO iter++
@@ -202,9 +410,7 @@ namespace sjtu {
              */
             iterator& operator--() {
                 if(curPo == 0){
-                    if(node -> prev -> prev == NULL){
-                        throw index_out_of_bound();
-                    }
+                    CheckPolicy::template require<index_out_of_bound>(node != NULL && node -> prev != NULL);
                     setNode(node -> prev);
                     curPo = node -> curLength;
                 }
@@ -215,18 +421,35 @@ namespace sjtu {
              * TODO *it
              */
             T& operator*() const {
-                if(curPo < 0 || curPo  >= node -> curLength){
-                    throw invalid_iterator();
-                }
-                else{
-                    return *(node -> arr[curPo]);
-                } 
+                CheckPolicy::template require<invalid_iterator>(node != NULL && curPo >= 0 && curPo < node -> curLength);
+                return *(node -> ptr(curPo));
             }
             /**
              * TODO it->field
              */
             T* operator->() const noexcept {
-                return node -> arr[curPo];
+                return node -> ptr(curPo);
+            }
+            /**
+             * it[n] is *(it + n), the order is the order of positions in the deque.
+             */
+            T& operator[](const long int &n) const {
+                return *(*this + n);
+            }
+            bool operator<(const iterator &rhs) const {
+                return node == rhs.node ? curPo < rhs.curPo : *this - rhs < 0;
+            }
+            bool operator>(const iterator &rhs) const {
+                return rhs < *this;
+            }
+            bool operator<=(const iterator &rhs) const {
+                return !(rhs < *this);
+            }
+            bool operator>=(const iterator &rhs) const {
+                return !(*this < rhs);
+            }
+            friend iterator operator+(const long int &n, const iterator &it) {
+                return it + n;
             }
             /**
              * a operator to check whether two iterators are same (pointing to the same memory).
@@ -255,6 +478,16 @@ namespace sjtu {
             friend class iterator;
             // it should has similar member method as iterator.
             // and it should be able to construct from an iterator.
+        public:
+            typedef std::random_access_iterator_tag iterator_category;
+#if __cplusplus > 201703L
+            typedef std::random_access_iterator_tag iterator_concept;
+#endif
+            typedef T value_type;
+            typedef long int difference_type;
+            typedef const T *pointer;
+            typedef const T &reference;
+            typedef deque segmented_deque;
         private:
             // data members.
             nodeT *node;
@@ -304,34 +537,11 @@ namespace sjtu {
             // if these two iterators points to different vectors, throw invaild_iterator.
             
             long int operator-(const const_iterator &rhs) const {
-                if(deqId != rhs.deqId){
-                    throw invalid_iterator();
-                }
+                CheckPolicy::template require<invalid_iterator>(deqId == rhs.deqId);
                 if(node == rhs.node){
-                    return (curPo) - (rhs.curPo);
-                }
-                nodeT *tmpNode = node -> next;
-                long int dist = node -> curLength - (curPo);
-                while(tmpNode != NULL && tmpNode != rhs.node){
-                    dist = dist + tmpNode -> curLength;
-                    tmpNode = tmpNode -> next;
-                }
-                if(tmpNode != NULL){
-                    dist = (dist + (rhs.curPo));
-                    return -dist;
-                }
-
-                dist = rhs.node -> curLength - (rhs.curPo );
-                tmpNode = rhs.node -> next;
-                while(tmpNode != NULL && tmpNode != node){
-                    dist = dist + tmpNode -> curLength;
-                    tmpNode = tmpNode -> next;
-                }
-                if(tmpNode != NULL){
-                    dist = (dist + (curPo));
-                    return dist;
+                    return curPo - rhs.curPo;
                 }
-                throw runtime_error();
+                return (long int)(deqId -> nodeBase(node) + curPo) - (long int)(deqId -> nodeBase(rhs.node) + rhs.curPo);
             }
             
             const_iterator& operator+=(const long int &n) {
@@ -339,48 +549,33 @@ namespace sjtu {
                     *this -= -n;
                     return *this;
                 }
-                if(node -> curLength == 0 || n == 0){
+                if(node == NULL || node -> curLength == 0 || n == 0){
                     return *this;
                 }
-                long int diff = n;
-                while(node -> next != NULL && diff >= node -> curLength  - curPo){
-                    diff = diff - ( node -> curLength  - curPo);
-                    setNode(node -> next);
-                    curPo = 0;
-                }
-                if(diff > node -> curLength  - curPo){
-                    throw index_out_of_bound();
-                }
-                curPo += diff;
+                long int dest = deqId -> nodeBase(node) + curPo + n;
+                CheckPolicy::template require<index_out_of_bound>(dest <= (long int)deqId -> sizeDeq);
+                setNode(deqId -> locate(dest, curPo));
                 return *this;
             }
             
             const_iterator& operator-=(const long int &n) {
-
                 if(n < 0){
                     *this += -n;
                     return *this;
                 }
-                if(node -> curLength == 0 || n == 0){
+                if(node == NULL || node -> curLength == 0 || n == 0){
                     return *this;
                 }
-                long int diff = n;
-                while(node -> prev -> prev != NULL && diff > curPo){
-                    diff = diff - (curPo + 1);
-                    setNode(node -> prev);
-                    curPo = node -> curLength - 1;
-                }
-                if(node -> prev -> prev == NULL && diff > curPo){
-                    throw index_out_of_bound();
-                }
-                curPo -= diff;
+                long int dest = deqId -> nodeBase(node) + curPo - n;
+                CheckPolicy::template require<index_out_of_bound>(dest >= 0);
+                setNode(deqId -> locate(dest, curPo));
                 return *this;
             }
             /**
              * TODO iter++
              */
             const_iterator operator++(int) {
-                iterator tmp = *this;
+                const_iterator tmp = *this;
                 ++*this;
                 return tmp;
             }
@@ -390,7 +585,6 @@ namespace sjtu {
             const_iterator& operator++() {
                 ++curPo;
                 if(curPo == nodeN && node -> next == NULL){
-                    curPo--;
                     return *this;
                 }
                 else{
@@ -416,33 +610,46 @@ namespace sjtu {
              */
             const_iterator& operator--() {
                 if(curPo == 0){
-                    if(node -> prev -> prev == NULL){
-                        
-                        return *this;
-                    }
+                    CheckPolicy::template require<index_out_of_bound>(node != NULL && node -> prev != NULL);
                     setNode(node -> prev);
-                    curPo =  node -> curLength;
+                    curPo = node -> curLength;
                 }
                 curPo--;
                 return *this;
-            
             }
             /**
              * TODO *it
              */
-            T& operator*() const {
-                if(curPo < 0 || curPo >= node -> curLength){
-                    throw invalid_iterator();
-                }
-                else{
-                    return *(node -> arr[curPo]);
-                } 
+            const T& operator*() const {
+                CheckPolicy::template require<invalid_iterator>(node != NULL && curPo >= 0 && curPo < node -> curLength);
+                return *(node -> ptr(curPo));
             }
             /**
              * TODO it->field
              */
-            T* operator->() const noexcept {
-                return node -> arr[curPo];
+            const T* operator->() const noexcept {
+                return node -> ptr(curPo);
+            }
+            /**
+             * it[n] is *(it + n), the order is the order of positions in the deque.
+             */
+            const T& operator[](const long int &n) const {
+                return *(*this + n);
+            }
+            bool operator<(const const_iterator &rhs) const {
+                return node == rhs.node ? curPo < rhs.curPo : *this - rhs < 0;
+            }
+            bool operator>(const const_iterator &rhs) const {
+                return rhs < *this;
+            }
+            bool operator<=(const const_iterator &rhs) const {
+                return !(rhs < *this);
+            }
+            bool operator>=(const const_iterator &rhs) const {
+                return !(*this < rhs);
+            }
+            friend const_iterator operator+(const long int &n, const const_iterator &it) {
+                return it + n;
             }
             
             /**
@@ -465,163 +672,992 @@ namespace sjtu {
             }
         };
 
+        /**
+         * a contiguous run of elements: data[0], ..., data[len - 1] sit next to each other.
+         */
+        template<class P>
+        struct basic_segment{
+            P data;
+            size_t len;
+        };
+        typedef basic_segment<T *> segment;
+        typedef basic_segment<const T *> const_segment;
+
+        /**
+         * walks the runs of a range in order, a node gives at most two of them.
+         * the end iterator has node == NULL.
+         * segments are handed out by value, so for the standard library it is only an
+         * input iterator (a C++20 forward iterator); it can still be copied and re-walked.
+         */
+        template<class P>
+        class segment_iterator {
+            friend class deque;
+        public:
+            typedef std::input_iterator_tag iterator_category;
+#if __cplusplus > 201703L
+            typedef std::forward_iterator_tag iterator_concept;
+#endif
+            typedef basic_segment<P> value_type;
+            typedef long int difference_type;
+            typedef const basic_segment<P> *pointer;
+            typedef basic_segment<P> reference;
+        private:
+            nodeT *node;
+            int curPo;
+            nodeT *lastNode;
+            int lastPo;
+            basic_segment<P> cur;
+            segment_iterator(nodeT *n, int c, nodeT *ln, int lp) {
+                node = n;
+                curPo = c;
+                lastNode = ln;
+                lastPo = lp;
+                settle();
+            }
+            // move on to the run starting at curPo, skipping exhausted nodes.
+            void settle(){
+                while(node != NULL){
+                    int end = node == lastNode ? lastPo : node -> curLength;
+                    if(curPo < end){
+                        cur.data = node -> ptr(curPo);
+                        cur.len = std::min(end - curPo, nodeN - node -> phys(curPo));
+                        return;
+                    }
+                    if(node == lastNode){
+                        break;
+                    }
+                    node = node -> next;
+                    curPo = 0;
+                }
+                node = NULL;
+                curPo = 0;
+                cur.data = NULL;
+                cur.len = 0;
+            }
+        public:
+            segment_iterator() {
+                node = NULL;
+                curPo = 0;
+                lastNode = NULL;
+                lastPo = 0;
+                cur.data = NULL;
+                cur.len = 0;
+            }
+            basic_segment<P> operator*() const {
+                return cur;
+            }
+            const basic_segment<P> *operator->() const {
+                return &cur;
+            }
+            segment_iterator &operator++() {
+                curPo += cur.len;
+                settle();
+                return *this;
+            }
+            segment_iterator operator++(int) {
+                segment_iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+            bool operator==(const segment_iterator &rhs) const {
+                return node == rhs.node && curPo == rhs.curPo;
+            }
+            bool operator!=(const segment_iterator &rhs) const {
+                return !(*this == rhs);
+            }
+        };
+        /**
+         * the runs of a range, for range-for: for(segment s : q.segments()).
+         * it borrows the deque and is invalidated by whatever invalidates its iterators.
+         */
+        template<class P>
+        class segment_range {
+            segment_iterator<P> first;
+        public:
+            explicit segment_range(const segment_iterator<P> &f) : first(f) {}
+            segment_iterator<P> begin() const {
+                return first;
+            }
+            segment_iterator<P> end() const {
+                return segment_iterator<P>();
+            }
+            bool empty() const {
+                return first == end();
+            }
+        };
+
     public:
+        /**
+         * head and tail are the first and the last node, there is no sentinel:
+         * head -> prev and tail -> next are NULL, and end() is (tail, tail -> curLength).
+         * an empty deque owns no node at all until the first element arrives,
+         * after that the last node is kept even when it becomes empty.
+         */
         nodeT *head;
         nodeT *tail;
         int sizeDeq;
         /**
-         * TODO Constructors
+         * the central map: the nodes head ... tail are kept in order
+         * in mapArr[mapBegin, mapEnd), and node -> idx is the slot of the node.
+         * packed is true when every node except the first and the last one is full,
+         * then an index is located with one division instead of a scan.
          */
-        deque() {
-            head = new nodeT;
-            tail = new nodeT;
-            head -> next = tail;
-            tail -> prev = head;
-            sizeDeq = 0;
-        }
-        deque(const deque &other) {
-            int i;
-            head = new nodeT;
-            nodeT *p;
-            nodeT *tmp = head;
-            nodeT *q = other.head -> next;
-            while(q != NULL){
-                p = new nodeT;
-                p -> curLength = q -> curLength;
-                for(i = 0; i < p -> curLength; i++){
-                    p -> arr[i] = new T(*(q -> arr[i]));
+        nodeT **mapArr;
+        size_t mapCap;
+        size_t mapBegin;
+        size_t mapEnd;
+        bool packed;
+        /**
+         * the counted index: while the map is not packed, fenTree is a Fenwick tree
+         * over the node lengths by map slot (fenTree[1, fenCap]), so positional
+         * lookups cost O(log(n / nodeN)) after middle inserts and erases.
+         * it is not maintained while packed is true.
+         */
+        long *fenTree;
+        size_t fenCap;
+        size_t fenStep;
+
+        void fenBuild(){
+            size_t i, j;
+            if(fenCap != mapCap){
+                freeArray(fenTree, fenCap + 1);
+                fenTree = allocArray<long>(mapCap + 1);
+                fenCap = mapCap;
+                for(fenStep = 1; fenStep * 2 <= fenCap; fenStep *= 2);
+            }
+            for(i = 0; i <= fenCap; i++){
+                fenTree[i] = 0;
+            }
+            for(i = mapBegin; i < mapEnd; i++){
+                fenTree[i + 1] = mapArr[i] -> curLength;
+            }
+            for(i = 1; i <= fenCap; i++){
+                j = i + (i & -i);
+                if(j <= fenCap){
+                    fenTree[j] += fenTree[i];
                 }
-                p -> prev = tmp;
-                tmp -> next = p;
-                p -> next = NULL;
-                tmp = p;
-                q = q -> next;
             }
-            tail = tmp;
-            sizeDeq = other.sizeDeq;
+        }
+        void fenAdd(size_t slot, long delta){
+            size_t i;
+            for(i = slot + 1; i <= fenCap; i += i & -i){
+                fenTree[i] += delta;
+            }
         }
         /**
-         * TODO Deconstructor
+         * total length of the map slots [0, slot).
          */
-        ~deque() {
-            nodeT *p = head -> next;
-            nodeT *q;
-            while(p != NULL){
-                q = p;
-                p = p -> next;
-                delete q;
+        size_t fenPrefix(size_t slot) const {
+            size_t i;
+            long sum = 0;
+            for(i = slot; i > 0; i -= i & -i){
+                sum += fenTree[i];
             }
-            delete head;
-            sizeDeq = 0;
+            return sum;
         }
         /**
-         * TODO assignment operator
+         * return the map slot holding index pos, pos becomes the offset inside it.
          */
-        deque &operator=(const deque &other) {
-            if(this == &other){
-                return *this;
-            }
-            int i;
-            nodeT *p = head -> next;
-            nodeT *q;
-            while(p != NULL){
-                q = p;
-                p = p -> next;
-                delete q;
-            }        
-            nodeT *tmp = head;
-            q = other.head -> next;
-            while(q != NULL){
-                p = new nodeT;
-                p -> curLength = q -> curLength;
-                for(i = 0; i < p -> curLength; i++){
-                    p -> arr[i] = new T(*(q -> arr[i]));
+        size_t fenFind(size_t &pos) const {
+            size_t slot = 0;
+            size_t step;
+            for(step = fenStep; step != 0; step >>= 1){
+                if(slot + step <= fenCap && (size_t)fenTree[slot + step] <= pos){
+                    slot += step;
+                    pos -= fenTree[slot];
                 }
-                p -> prev = tmp;
-                tmp -> next = p;
-                p -> next = NULL;
-                tmp = p;
-                q = q -> next;
             }
-            tail = tmp;
-            sizeDeq = other.sizeDeq;
-            return *this;
+            return slot;
         }
         /**
-         * access specified element with bounds checking
-         * throw index_out_of_bound if out of bound.
+         * cached node positions: node -> base is the coordinate of its first element,
+         * where the front element of the deque has coordinate origin.
+         * push_front/pop_front only move origin, push_back/pop_back change no position,
+         * any other insert or erase bumps epoch so that every cached base goes stale
+         * and is recomputed once, on demand, from the counted index.
          */
-        T & at(const size_t &pos) {
-            return operator[](pos);
-        }
-        const T & at(const size_t &pos) const {
-
-            return operator[](pos);
+        size_t epoch;
+        long origin;
+        /**
+         * an erase that leaves a node with fewer than minFill elements merges it
+         * into a neighbour or borrows from one, see rebalance().
+         */
+        int minFill;
+        /**
+         * nodes freed at either end go to a short free list of at most spareMax
+         * nodes and are handed out again before asking the allocator, so a deque
+         * oscillating around a node boundary stops allocating.
+         */
+        nodeT *spare;
+        int spareCnt;
+        int spareMax;
+        Allocator alloc;
+        /**
+         * called after the length of node changed by delta.
+         */
+        void resized(nodeT *node, long delta){
+            if(!packed){
+                fenAdd(node -> idx, delta);
+            }
         }
 
-        T & operator[](const size_t &pos) {
-            int distt = pos;
-            
-            if(distt < 0){
-               
-                throw index_out_of_bound();
-            }
-            nodeT *optNode = head -> next;
-            
-            while(optNode != NULL && distt >= optNode -> curLength){
-                distt -= optNode ->curLength;
-                optNode = optNode -> next;
+        /**
+         * make sure there are front free slots before mapBegin
+         * and back free slots after mapEnd, re-centering the nodes.
+         */
+        void mapReserve(size_t front, size_t back){
+            if(mapBegin >= front && mapCap - mapEnd >= back){
+                return;
             }
-            if(optNode == NULL){
-                throw index_out_of_bound();
+            size_t i;
+            size_t cnt = mapEnd - mapBegin;
+            size_t need = cnt + front + back;
+            size_t newBegin;
+            if(mapCap < 2 * need){
+                size_t newCap = 2 * need + 8;
+                nodeT **newMap = allocArray<nodeT *>(newCap);
+                newBegin = (newCap - need) / 2 + front;
+                if(cnt != 0){
+                    std::memcpy(newMap + newBegin, mapArr + mapBegin, cnt * sizeof(nodeT *));
+                }
+                freeArray(mapArr, mapCap);
+                mapArr = newMap;
+                mapCap = newCap;
             }
-            return *(optNode -> arr[distt]);
-        }
-        const T & operator[](const size_t &pos) const{
-            int distt = pos;
-            if(distt < 0){
-                throw index_out_of_bound();
+            else{
+                newBegin = (mapCap - need) / 2 + front;
+                std::memmove(mapArr + newBegin, mapArr + mapBegin, cnt * sizeof(nodeT *));
             }
-
-            nodeT *optNode = head -> next;
-            
-            while(optNode != NULL && distt >= optNode -> curLength){
-                distt -= optNode ->curLength;
-                optNode = optNode -> next;
+            mapBegin = newBegin;
+            mapEnd = newBegin + cnt;
+            for(i = mapBegin; i < mapEnd; i++){
+                mapArr[i] -> idx = i;
             }
-            if(optNode == NULL){
-                throw index_out_of_bound();
+            if(!packed){
+                fenBuild();
             }
-            return *(optNode -> arr[distt]);
         }
         /**
-         * access the first element
-         * throw container_is_empty when the container is empty.
+         * put the n nodes p, p -> next, ... into the map as the k-th node and on,
+         * shifting the shorter side. the counted index includes their lengths afterwards.
          */
-        const T & front() const {
-            if(sizeDeq == 0){
-                throw container_is_empty();
+        void mapInsert(nodeT *p, size_t k, size_t n = 1){
+            size_t i;
+            size_t cnt = mapEnd - mapBegin;
+            if(k == 0 && cnt != 0){
+                // nodeBase() keeps no cache for the first node, drop it now that it stops being first.
+                mapArr[mapBegin] -> baseEpoch.store(epoch - 1, std::memory_order_relaxed);
+            }
+            if(k < cnt - k){
+                mapReserve(n, 0);
+                mapBegin -= n;
+                for(i = mapBegin; i < mapBegin + k; i++){
+                    mapArr[i] = mapArr[i + n];
+                    mapArr[i] -> idx = i;
+                }
+            }
+            else{
+                mapReserve(0, n);
+                for(i = mapEnd; i > mapBegin + k; i--){
+                    mapArr[i - 1 + n] = mapArr[i - 1];
+                    mapArr[i - 1 + n] -> idx = i - 1 + n;
+                }
+                mapEnd += n;
+            }
+            for(i = mapBegin + k; i < mapBegin + k + n; i++){
+                mapArr[i] = p;
+                p -> idx = i;
+                p = p -> next;
+            }
+            if(!packed){
+                if(k != 0 && k != cnt){
+                    fenBuild();
+                }
+                else{
+                    for(i = mapBegin + k; i < mapBegin + k + n; i++){
+                        fenAdd(i, mapArr[i] -> curLength);
+                    }
+                }
             }
-            return *(head -> next -> arr[0]);
+        }
+        /**
+         * remove p and the n - 1 nodes after it from the map, shifting the shorter side.
+         */
+        void mapErase(nodeT *p, size_t n = 1){
+            size_t i;
+            size_t at = p -> idx;
+            size_t k = at - mapBegin;
+            for(i = at; i < at + n; i++){
+                resized(mapArr[i], -mapArr[i] -> curLength);
+            }
+            if(k < mapEnd - mapBegin - n - k){
+                for(i = at + n; i > mapBegin + n; i--){
+                    mapArr[i - 1] = mapArr[i - 1 - n];
+                    mapArr[i - 1] -> idx = i - 1;
+                }
+                mapBegin += n;
+            }
+            else{
+                for(i = at; i + n < mapEnd; i++){
+                    mapArr[i] = mapArr[i + n];
+                    mapArr[i] -> idx = i;
+                }
+                mapEnd -= n;
+            }
+            if(!packed && k != 0 && k != mapEnd - mapBegin){
+                fenBuild();
+            }
+        }
+        /**
+         * empty the map and put tail back as its only node.
+         */
+        void mapReset(){
+            packed = true;
+            epoch++;
+            origin = 0;
+            mapBegin = mapEnd = mapCap / 2;
+            if(tail != NULL){
+                mapInsert(tail, 0);
+            }
+        }
+        /**
+         * allocate the first node of a deque that owns none.
+         */
+        void initNode(){
+            head = tail = newNode();
+            mapReset();
+        }
+        /**
+         * link a fresh node p right after node, or in front of head if node is NULL.
+         */
+        void linkAfter(nodeT *node, nodeT *p){
+            // the map first: if it has to grow and that throws, the list is untouched.
+            mapInsert(p, node == NULL ? 0 : node -> idx + 1 - mapBegin);
+            p -> prev = node;
+            p -> next = (node == NULL ? head : node -> next);
+            if(p -> next != NULL){
+                p -> next -> prev = p;
+            }
+            else{
+                tail = p;
+            }
+            if(node != NULL){
+                node -> next = p;
+            }
+            else{
+                head = p;
+            }
+        }
+        /**
+         * link a fresh node holding one element constructed from args right after node,
+         * or in front of head if node is NULL. nothing changes if that throws.
+         */
+        template<class... Args>
+        nodeT *linkNew(nodeT *node, Args&&... args){
+            nodeT *p = newNode();
+            try{
+                p -> construct(0, std::forward<Args>(args)...);
+                p -> curLength = 1;
+                linkAfter(node, p);
+            }
+            catch(...){
+                freeNode(p);
+                throw;
+            }
+            return p;
+        }
+        /**
+         * unlink node p from the list and the map and free it, p must not be the only node.
+         */
+        void unlink(nodeT *p){
+            unlink(p, p);
+        }
+        /**
+         * unlink the nodes p ... q from the list and the map and free them,
+         * they must not be all the nodes.
+         */
+        void unlink(nodeT *p, nodeT *q){
+            if(p -> prev != NULL){
+                p -> prev -> next = q -> next;
+            }
+            else{
+                head = q -> next;
+            }
+            if(q -> next != NULL){
+                q -> next -> prev = p -> prev;
+            }
+            else{
+                tail = p -> prev;
+            }
+            q -> next = NULL;
+            mapErase(p, q -> idx - p -> idx + 1);
+            while(p != NULL){
+                nodeT *r = p;
+                p = p -> next;
+                freeNode(r);
+            }
+            if(mapEnd - mapBegin <= 2){
+                packed = true;
+            }
+        }
+        /**
+         * called after the length of node changed in the middle of the deque.
+         */
+        void checkPacked(nodeT *node){
+            if(packed && node -> curLength != nodeN && node != head && node != tail){
+                packed = false;
+                fenBuild();
+            }
+        }
+        /**
+         * split node, its elements [h, curLength) move to a new node linked after it.
+         */
+        void splitNode(nodeT *node, int h){
+            int cnt = node -> curLength - h;
+            nodeT *q = newNode();
+            linkAfter(node, q);
+            q -> prependFrom(node, cnt);
+            resized(q, cnt);
+            resized(node, -cnt);
+            checkPacked(node);
+            checkPacked(q);
+        }
+        /**
+         * node has just lost an element. if it holds fewer than minFill elements now,
+         * merge it with a neighbour when both fit in one node, otherwise borrow
+         * from the longer neighbour. (node, curPo) is updated to keep pointing
+         * to the same element.
+         */
+        void rebalance(nodeT *&node, int &curPo){
+            if(node -> curLength >= minFill){
+                return;
+            }
+            // borrowing moves the first element of node, so cached bases go stale.
+            epoch++;
+            nodeT *prev = node -> prev;
+            nodeT *next = node -> next;
+            int cnt;
+            if(next != NULL && node -> curLength + next -> curLength <= nodeN){
+                cnt = next -> curLength;
+                node -> appendFrom(next, cnt);
+                resized(node, cnt);
+                resized(next, -cnt);
+                unlink(next);
+                next = NULL;
+            }
+            else if(prev != NULL && prev -> curLength + node -> curLength <= nodeN){
+                cnt = node -> curLength;
+                curPo += prev -> curLength;
+                prev -> appendFrom(node, cnt);
+                resized(prev, cnt);
+                resized(node, -cnt);
+                unlink(node);
+                node = prev;
+                prev = NULL;
+            }
+            else if(next != NULL && (prev == NULL || next -> curLength >= prev -> curLength)){
+                cnt = (next -> curLength - node -> curLength) / 2;
+                node -> appendFrom(next, cnt);
+                resized(node, cnt);
+                resized(next, -cnt);
+            }
+            else if(prev != NULL){
+                cnt = (prev -> curLength - node -> curLength) / 2;
+                node -> prependFrom(prev, cnt);
+                curPo += cnt;
+                resized(node, cnt);
+                resized(prev, -cnt);
+            }
+            checkPacked(node);
+            if(prev != NULL){
+                checkPacked(prev);
+            }
+            if(next != NULL){
+                checkPacked(next);
+            }
+        }
+        /**
+         * the fill factor used by erase, clamped to [0, nodeN / 2].
+         */
+        void set_min_fill(int fill){
+            if(fill < 0){
+                fill = 0;
+            }
+            if(fill > nodeN / 2){
+                fill = nodeN / 2;
+            }
+            minFill = fill;
+        }
+        int min_fill() const {
+            return minFill;
+        }
+        /**
+         * n objects of type U from a rebound copy of the allocator.
+         */
+        template<class U>
+        U *allocArray(size_t n){
+            typedef typename allocTraits::template rebind_alloc<U> uAlloc;
+            uAlloc a(alloc);
+            return std::allocator_traits<uAlloc>::allocate(a, n);
+        }
+        template<class U>
+        void freeArray(U *p, size_t n){
+            typedef typename allocTraits::template rebind_alloc<U> uAlloc;
+            if(p != NULL){
+                uAlloc a(alloc);
+                std::allocator_traits<uAlloc>::deallocate(a, p, n);
+            }
+        }
+        void deleteNode(nodeT *p){
+            p -> ~nodeT();
+            freeArray(p, 1);
+        }
+        /**
+         * a fresh empty node, from the free list if possible.
+         */
+        nodeT *newNode(){
+            if(spare == NULL){
+                nodeT *p = allocArray<nodeT>(1);
+                try{
+                    new (p) nodeT(alloc);
+                }
+                catch(...){
+                    freeArray(p, 1);
+                    throw;
+                }
+                return p;
+            }
+            nodeT *p = spare;
+            spare = p -> next;
+            spareCnt--;
+            p -> next = NULL;
+            p -> baseEpoch.store(0, std::memory_order_relaxed);
+            return p;
+        }
+        /**
+         * destroy the elements of p and keep it for newNode(), or free it if the list is full.
+         */
+        void freeNode(nodeT *p){
+            if(spareCnt >= spareMax){
+                deleteNode(p);
+                return;
+            }
+            p -> clear();
+            p -> prev = NULL;
+            p -> next = spare;
+            spare = p;
+            spareCnt++;
+        }
+        /**
+         * the number of spare nodes kept for reuse, two by default: one for each end.
+         */
+        void set_spare_nodes(int cnt){
+            if(cnt < 0){
+                cnt = 0;
+            }
+            spareMax = cnt;
+            while(spareCnt > spareMax){
+                nodeT *p = spare;
+                spare = p -> next;
+                spareCnt--;
+                deleteNode(p);
+            }
+        }
+        int spare_nodes() const {
+            return spareMax;
+        }
+        /**
+         * number of elements stored before node.
+         */
+        size_t nodeBase(nodeT *node) const {
+            if(node == head){
+                return 0;
+            }
+            if(packed){
+                return head -> curLength + (node -> idx - mapBegin - 1) * nodeN;
+            }
+            // readers racing on a stale node all store the same value, base is published by the release.
+            if(node -> baseEpoch.load(std::memory_order_acquire) != epoch){
+                node -> base.store(origin + (long)fenPrefix(node -> idx), std::memory_order_relaxed);
+                node -> baseEpoch.store(epoch, std::memory_order_release);
+            }
+            return node -> base.load(std::memory_order_relaxed) - origin;
+        }
+        /**
+         * return the node holding the element at index pos and put its offset into curPo,
+         * pos >= size() gives the end position.
+         */
+        nodeT *locate(size_t pos, int &curPo) const {
+            if(pos >= (size_t)sizeDeq){
+                curPo = (tail == NULL ? 0 : tail -> curLength);
+                return tail;
+            }
+            if(pos < (size_t)head -> curLength){
+                curPo = pos;
+                return head;
+            }
+            if(packed){
+                pos -= head -> curLength;
+                curPo = pos % nodeN;
+                return mapArr[mapBegin + 1 + pos / nodeN];
+            }
+            size_t slot = fenFind(pos);
+            curPo = pos;
+            return mapArr[slot];
+        }
+        /**
+         * make node hold copies of the next n elements of the sequence at (src, from),
+         * advancing the cursor. live slots of node are assigned to, missing ones are
+         * built and extra ones destroyed. the copy goes one contiguous run at a time,
+         * so trivially copyable elements end up in memmove.
+         */
+        static void copyInto(nodeT *node, int n, nodeT *&src, int &from){
+            int i;
+            int k = 0;
+            int c;
+            while(k < n){
+                if(from == src -> curLength){
+                    src = src -> next;
+                    from = 0;
+                }
+                int t = node -> phys(k);
+                int f = src -> phys(from);
+                c = std::min(n - k, src -> curLength - from);
+                c = std::min(c, std::min(nodeN - t, nodeN - f));
+                T *first = src -> ptr(from);
+                if(k < node -> curLength){
+                    c = std::min(c, node -> curLength - k);
+                    std::copy(first, first + c, node -> ptr(k));
+                }
+                else if(std::is_same<Allocator, std::allocator<T> >::value){
+                    std::uninitialized_copy(first, first + c, node -> ptr(k));
+                    node -> curLength += c;
+                }
+                else{
+                    // the allocator may want to see every construction.
+                    for(i = 0; i < c; i++){
+                        node -> construct(k + i, first[i]);
+                        node -> curLength++;
+                    }
+                }
+                k += c;
+                from += c;
+            }
+            while(node -> curLength > n){
+                node -> curLength--;
+                node -> destroy(node -> curLength);
+            }
+        }
+        /**
+         * replace the contents with a copy of other, packed into full nodes.
+         * the nodes we already own are reused in order, their elements assigned to
+         * in place; missing nodes are allocated and spare ones freed.
+         * if a copy throws, the deque is released and left empty.
+         */
+        void copyFrom(const deque &other){
+            size_t left = other.sizeDeq;
+            size_t cnt = 0;
+            int from = 0;
+            int c;
+            nodeT *src = other.head;
+            nodeT *p = head;
+            nodeT *last = NULL;
+            // every node reachable from head holds exactly curLength live elements
+            // at any point, so release() can clean up whatever a throw leaves behind.
+            try{
+                while(p != NULL && left != 0){
+                    c = (left < (size_t)nodeN ? left : nodeN);
+                    copyInto(p, c, src, from);
+                    left -= c;
+                    last = p;
+                    p = p -> next;
+                    cnt++;
+                }
+                if(last != NULL){
+                    last -> next = NULL;
+                }
+                else{
+                    head = NULL;
+                }
+                while(p != NULL){
+                    nodeT *q = p;
+                    p = p -> next;
+                    freeNode(q);
+                }
+                while(left != 0){
+                    p = newNode();
+                    p -> prev = last;
+                    if(last != NULL){
+                        last -> next = p;
+                    }
+                    else{
+                        head = p;
+                    }
+                    last = p;
+                    cnt++;
+                    c = (left < (size_t)nodeN ? left : nodeN);
+                    copyInto(p, c, src, from);
+                    left -= c;
+                }
+            }
+            catch(...){
+                release();
+                throw;
+            }
+            tail = last;
+            sizeDeq = other.sizeDeq;
+            packed = true;
+            epoch++;
+            origin = 0;
+            mapBegin = mapEnd = mapCap / 2;
+            if(cnt != 0){
+                mapInsert(head, 0, cnt);
+            }
+        }
+        /**
+         * TODO Constructors
+         */
+        deque() : deque(Allocator()) {}
+        explicit deque(const Allocator &a) : alloc(a) {
+            head = tail = NULL;
+            sizeDeq = 0;
+            mapArr = NULL;
+            mapCap = 0;
+            fenTree = NULL;
+            fenCap = fenStep = 0;
+            epoch = 0;
+            minFill = nodeN / 4;
+            spare = NULL;
+            spareCnt = 0;
+            spareMax = 2;
+            mapReset();
+        }
+        deque(const deque &other) : alloc(allocTraits::select_on_container_copy_construction(other.alloc)) {
+            head = tail = NULL;
+            sizeDeq = 0;
+            mapArr = NULL;
+            mapCap = mapBegin = mapEnd = 0;
+            fenTree = NULL;
+            fenCap = fenStep = 0;
+            epoch = 1;
+            origin = 0;
+            minFill = other.minFill;
+            spare = NULL;
+            spareCnt = 0;
+            spareMax = other.spareMax;
+            packed = true;
+            copyFrom(other);
+        }
+        /**
+         * steal the nodes and the map of other, which is left empty.
+         */
+        deque(deque &&other) noexcept : alloc(other.alloc) {
+            head = tail = NULL;
+            sizeDeq = 0;
+            mapArr = NULL;
+            mapCap = mapBegin = mapEnd = 0;
+            fenTree = NULL;
+            fenCap = fenStep = 0;
+            epoch = 1;
+            origin = 0;
+            minFill = other.minFill;
+            spare = NULL;
+            spareCnt = 0;
+            spareMax = other.spareMax;
+            packed = true;
+            swapContents(other);
+        }
+        /**
+         * TODO Deconstructor
+         */
+        ~deque() {
+            release();
+        }
+        /**
+         * free every node, spare node and index array, leaving an empty deque
+         * that owns no memory.
+         */
+        void release(){
+            nodeT *p = head;
+            nodeT *q;
+            while(p != NULL){
+                q = p;
+                p = p -> next;
+                deleteNode(q);
+            }
+            while(spare != NULL){
+                q = spare;
+                spare = spare -> next;
+                deleteNode(q);
+            }
+            spareCnt = 0;
+            freeArray(mapArr, mapCap);
+            freeArray(fenTree, fenCap + 1);
+            head = tail = NULL;
+            sizeDeq = 0;
+            mapArr = NULL;
+            mapCap = 0;
+            fenTree = NULL;
+            fenCap = fenStep = 0;
+            mapReset();
+        }
+        /**
+         * TODO assignment operator
+         */
+        deque &operator=(const deque &other) {
+            if(this == &other){
+                return *this;
+            }
+            copyAssignAlloc(other, typename allocTraits::propagate_on_container_copy_assignment());
+            copyFrom(other);
+            return *this;
+        }
+        // the allocator is assigned only by these templates, so an allocator that cannot be
+        // assigned (std::pmr::polymorphic_allocator) never instantiates the assignment.
+        template<class A = Allocator>
+        void copyAssignAlloc(const deque &other, std::true_type){
+            if(!(alloc == other.alloc)){
+                release();
+                alloc = other.alloc;
+            }
+        }
+        void copyAssignAlloc(const deque &, std::false_type){}
+        /**
+         * the old contents are released, other is left empty.
+         * with an allocator that stays put and compares unequal the elements are
+         * moved one by one instead.
+         */
+        deque &operator=(deque &&other) noexcept(allocTraits::propagate_on_container_move_assignment::value) {
+            if(this != &other){
+                moveAssign(other, typename allocTraits::propagate_on_container_move_assignment());
+            }
+            return *this;
+        }
+        template<class A = Allocator>
+        void moveAssign(deque &other, std::true_type){
+            release();
+            alloc = std::move(other.alloc);
+            swapContents(other);
+        }
+        void moveAssign(deque &other, std::false_type){
+            if(alloc == other.alloc){
+                release();
+                swapContents(other);
+                return;
+            }
+            clear();
+            nodeT *p;
+            int i;
+            for(p = other.head; p != NULL; p = p -> next){
+                for(i = 0; i < p -> curLength; i++){
+                    emplace_back(std::move(*(p -> ptr(i))));
+                }
+            }
+            other.clear();
+        }
+        /**
+         * exchange the contents of two deques in O(1).
+         * iterators keep pointing to their elements but still refer to the old deque.
+         */
+        void swap(deque &other) noexcept {
+            swapAlloc(other, typename allocTraits::propagate_on_container_swap());
+            swapContents(other);
+        }
+        template<class A = Allocator>
+        void swapAlloc(deque &other, std::true_type){
+            using std::swap;
+            swap(alloc, other.alloc);
+        }
+        void swapAlloc(deque &, std::false_type){}
+        /**
+         * swap everything but the allocators.
+         */
+        void swapContents(deque &other) noexcept {
+            std::swap(head, other.head);
+            std::swap(tail, other.tail);
+            std::swap(sizeDeq, other.sizeDeq);
+            std::swap(mapArr, other.mapArr);
+            std::swap(mapCap, other.mapCap);
+            std::swap(mapBegin, other.mapBegin);
+            std::swap(mapEnd, other.mapEnd);
+            std::swap(packed, other.packed);
+            std::swap(fenTree, other.fenTree);
+            std::swap(fenCap, other.fenCap);
+            std::swap(fenStep, other.fenStep);
+            std::swap(epoch, other.epoch);
+            std::swap(origin, other.origin);
+            std::swap(minFill, other.minFill);
+            std::swap(spare, other.spare);
+            std::swap(spareCnt, other.spareCnt);
+            std::swap(spareMax, other.spareMax);
+        }
+        allocator_type get_allocator() const {
+            return alloc;
+        }
+        /**
+         * access specified element with bounds checking
+         * throw index_out_of_bound if out of bound.
+         */
+        T & at(const size_t &pos) {
+            if(pos >= (size_t)sizeDeq){
+                throw index_out_of_bound();
+            }
+            return element(pos);
+        }
+        const T & at(const size_t &pos) const {
+            if(pos >= (size_t)sizeDeq){
+                throw index_out_of_bound();
+            }
+            return element(pos);
+        }
+        /**
+         * access specified element, bounds are checked as CheckPolicy says.
+         */
+        T & operator[](const size_t &pos) {
+            CheckPolicy::template require<index_out_of_bound>(pos < (size_t)sizeDeq);
+            return element(pos);
+        }
+        const T & operator[](const size_t &pos) const{
+            CheckPolicy::template require<index_out_of_bound>(pos < (size_t)sizeDeq);
+            return element(pos);
+        }
+        /**
+         * the element at pos, unchecked. a const deque only hands out const references.
+         */
+        T & element(size_t pos) {
+            int offset;
+            nodeT *optNode = locate(pos, offset);
+            return *(optNode -> ptr(offset));
+        }
+        const T & element(size_t pos) const {
+            int offset;
+            nodeT *optNode = locate(pos, offset);
+            return *(optNode -> ptr(offset));
+        }
+        /**
+         * access the first element
+         * throw container_is_empty when the container is empty (under the checked policy).
+         */
+        const T & front() const {
+            CheckPolicy::template require<container_is_empty>(sizeDeq != 0);
+            return *(head -> ptr(0));
         }
         /**
          * access the last element
-         * throw container_is_empty when the container is empty.
+         * throw container_is_empty when the container is empty (under the checked policy).
          */
         const T & back() const {
-            if(sizeDeq == 0){
-                throw container_is_empty();
-            }
-            return *(tail -> arr[tail -> curLength - 1]);
+            CheckPolicy::template require<container_is_empty>(sizeDeq != 0);
+            return *(tail -> ptr(tail -> curLength - 1));
         }
         /**
          * returns an iterator to the beginning.
          */
         iterator begin() {
-            return iterator(head -> next, 0, this);
+            return iterator(head, 0, this);
         }
         const_iterator cbegin() const {
-            return const_iterator(head -> next, 0, this);
+            return const_iterator(head, 0, this);
         }
         /**
          * returns an iterator to the end.
@@ -638,6 +1674,27 @@ namespace sjtu {
             }
             return const_iterator(tail ,tail -> curLength, this);
         }
+        /**
+         * the elements as {data, len} runs of contiguous storage, in order,
+         * to hand whole blocks to code that works on plain arrays.
+         */
+        segment_range<T *> segments() {
+            return segments(begin(), end());
+        }
+        segment_range<const T *> segments() const {
+            return segments(cbegin(), cend());
+        }
+        /**
+         * the runs of [first, last), the outer ones cut to the range.
+         */
+        segment_range<T *> segments(const iterator &first, const iterator &last) {
+            CheckPolicy::template require<invalid_iterator>(first.deqId == this && last.deqId == this);
+            return segment_range<T *>(segment_iterator<T *>(first.node, first.curPo, last.node, last.curPo));
+        }
+        segment_range<const T *> segments(const const_iterator &first, const const_iterator &last) const {
+            CheckPolicy::template require<invalid_iterator>(first.deqId == this && last.deqId == this);
+            return segment_range<const T *>(segment_iterator<const T *>(first.node, first.curPo, last.node, last.curPo));
+        }
         /**
          * checks whether the container is empty.
          */
@@ -652,21 +1709,25 @@ namespace sjtu {
         }
         /**
          * clears the contents
+         * head stays as the only, empty node and the map keeps its buffer, the other
+         * nodes go to the free list up to spare_nodes(), so refilling allocates little.
          */
         void clear() {
-            int i;
+            if(head == NULL){
+                return;
+            }
             nodeT *p = head -> next;
             nodeT *q = NULL;
             while(p != NULL){
                 q = p;
                 p = p -> next;     
-                delete q;
+                freeNode(q);
             }
-            tail = new nodeT;
-            tail -> prev = head;
-            head -> next = tail;
+            head -> clear();
+            head -> next = NULL;
+            tail = head;
             sizeDeq = 0;
-
+            mapReset();
         }
         /**
          * inserts elements at the specified locat on in the container.
@@ -675,88 +1736,268 @@ namespace sjtu {
          *     throw if the iterator is invalid or it point to a wrong place.
          */
         iterator insert(iterator pos, const T &value) {
+            return emplace(pos, value);
+        }
+        iterator insert(iterator pos, T &&value) {
+            return emplace(pos, std::move(value));
+        }
+        /**
+         * constructs an element from args in place before pos.
+         * returns an iterator pointing to the new element.
+         *     throw if the iterator is invalid or it point to a wrong place.
+         */
+        template<class... Args>
+        iterator emplace(iterator pos, Args&&... args) {
             if(this != pos.deqId){
                 throw invalid_iterator();
             }
+            if(pos.node == NULL){
+                emplace_back(std::forward<Args>(args)...);
+                return begin();
+            }
             if(pos.curPo > pos.node -> curLength){
                 throw invalid_iterator();
             }
-            sizeDeq++;
-            if(pos.node -> curLength == nodeN && pos.node == tail){
-                nodeT *p;
-                if(pos.curPo == nodeN){
-                    p =  new nodeT;
-                    p -> next = NULL;
-                    p -> prev = pos.node;
-                    pos.node -> next = p;
-                    p -> arr[0] = new T(value);
-                    p -> curLength = 1;
-                    tail = p;
+            // only an append keeps every cached position, decide before tail can move.
+            bool shifts = (pos.node != tail || pos.curPo != pos.node -> curLength);
+            if(pos.curPo == nodeN){
+                nodeT *p = linkNew(pos.node, std::forward<Args>(args)...);
+                if(shifts){
+                    epoch++;
                 }
-                else{
-                    p =  new nodeT;
-                    p -> next = NULL;
-                    p -> prev = pos.node;
-                    pos.node -> next = p;
-                    p -> arr[0] = pos.node -> arr[nodeN - 1];
-                    p -> curLength = 1;
-                    tail = p;
-                    int tmpPo = nodeN - 1;
-                    while(tmpPo != pos.curPo){
-                        pos.node -> arr[tmpPo] = pos.node -> arr[tmpPo - 1];
-                        tmpPo = tmpPo - 1;
-                    }
-                    pos.node -> arr[tmpPo] = new T(value);
-                    return pos;
+                sizeDeq++;
+                checkPacked(p);
+                return iterator(p, 0, this);
+            }
+            // args may refer to an element that is about to be shifted,
+            // and a throwing constructor must find the deque untouched.
+            T tmp(std::forward<Args>(args)...);
+            if(shifts){
+                epoch++;
+            }
+            if(pos.node -> curLength == nodeN){
+                // split a full node in half and insert into the half holding pos.
+                int h = nodeN / 2;
+                splitNode(pos.node, h);
+                if(pos.curPo > h){
+                    pos.setNode(pos.node -> next);
+                    pos.curPo -= h;
                 }
             }
-            if(pos.node -> curLength == nodeN && pos.node -> next -> curLength == nodeN){
-                nodeT *p;
-                p =  new nodeT;
-                p -> next = pos.node -> next;
-                pos.node -> next -> prev = p;
-                p -> prev = pos.node;
-                pos.node -> next = p;
-                p -> arr[0] = pos.node -> arr[nodeN - 1];
-                p -> curLength = 1;
-                int tmpPo = nodeN - 1;
-                while(tmpPo != pos.curPo){
-                    pos.node -> arr[tmpPo] = pos.node -> arr[tmpPo - 1];
-                    tmpPo = tmpPo - 1;
-                }
-                pos.node -> arr[tmpPo] = new T(value);
-                return pos;
+            pos.node -> openSlot(pos.curPo);
+            try{
+                pos.node -> construct(pos.curPo, std::move(tmp));
             }
-            
-            if(pos.node -> curLength == nodeN && pos.node -> next -> curLength != nodeN){
-                nodeT *tmpNode = pos.node -> next;
-                int tmpPo = tmpNode -> curLength;
-                while(tmpPo != 0){
-                    tmpNode -> arr[tmpPo] = tmpNode -> arr[tmpPo - 1];
-                    tmpPo = tmpPo - 1;
-                }
-                tmpNode -> arr[tmpPo] = pos.node -> arr[nodeN - 1];
-                tmpNode -> curLength++;
-                
-                tmpPo = nodeN - 1;
-                while(tmpPo != pos.curPo){
-                    pos.node -> arr[tmpPo] = pos.node -> arr[tmpPo - 1];
-                    tmpPo = tmpPo - 1;
-                }
-                pos.node -> arr[tmpPo] = new T(value);
-                return pos;
+            catch(...){
+                pos.node -> closeSlot(pos.curPo);
+                throw;
             }
-            else{ 
-               
-                int tmpPo = pos.node -> curLength;
-                while(tmpPo != pos.curPo){
-                    pos.node -> arr[tmpPo] = pos.node -> arr[tmpPo - 1];
-                    tmpPo = tmpPo - 1;
-                }
-                pos.node -> arr[tmpPo] = new T(value);
-                pos.node -> curLength++;
+            sizeDeq++;
+            resized(pos.node, 1);
+            checkPacked(pos.node);
+            return pos;
+        }
+        /**
+         * inserts the elements of [first, last) before pos.
+         * returns an iterator pointing to the first inserted element, or pos if the range is empty.
+         */
+        template<class InputIt>
+        iterator insert(iterator pos, InputIt first, InputIt last,
+                        typename std::enable_if<!std::is_integral<InputIt>::value>::type * = NULL) {
+            rangeSource<InputIt> src(first, last);
+            return insertFrom(pos, src);
+        }
+        /**
+         * inserts n copies of value before pos.
+         * returns an iterator pointing to the first inserted element, or pos if n == 0.
+         */
+        iterator insert(iterator pos, size_t n, const T &value) {
+            // value may refer to an element that is about to be moved.
+            T tmp(value);
+            fillSource src(n, tmp);
+            return insertFrom(pos, src);
+        }
+        /**
+         * appends the elements of [first, last) to the end.
+         */
+        template<class InputIt>
+        void append(InputIt first, InputIt last) {
+            insert(end(), first, last);
+        }
+        /**
+         * element producers for insertFrom().
+         */
+        template<class InputIt>
+        struct rangeSource{
+            InputIt first, last;
+            rangeSource(InputIt first, InputIt last) : first(first), last(last) {}
+            bool more() const {
+                return first != last;
+            }
+            void build(nodeT *p){
+                p -> construct(p -> curLength, *first);
+                p -> curLength++;
+                ++first;
+            }
+        };
+        struct fillSource{
+            size_t n;
+            const T &value;
+            fillSource(size_t n, const T &value) : n(n), value(value) {}
+            bool more() const {
+                return n != 0;
+            }
+            void build(nodeT *p){
+                p -> construct(p -> curLength, value);
+                p -> curLength++;
+                n--;
+            }
+        };
+        /**
+         * bulk insertion before pos: the node holding pos is split once, the node in
+         * front of the gap is topped up, the rest is packed into a chain of full new
+         * nodes spliced in with a single map update, and the node behind the gap is
+         * merged into the last new node when they fit. O(k + nodeN) plus the map shift.
+         */
+        template<class Source>
+        iterator insertFrom(iterator pos, Source &src) {
+            if(this != pos.deqId){
+                throw invalid_iterator();
+            }
+            if(pos.node != NULL && pos.curPo > pos.node -> curLength){
+                throw invalid_iterator();
+            }
+            // nothing to insert: a deque that owns no node keeps owning none.
+            if(!src.more()){
                 return pos;
             }
+            if(pos.node == NULL){
+                initNode();
+                pos = begin();
+            }
+            size_t index = nodeBase(pos.node) + pos.curPo;
+            nodeT *left;
+            nodeT *right;
+            if(pos.node -> curLength == 0){
+                left = pos.node;
+                right = NULL;
+            }
+            else if(pos.curPo == 0){
+                left = pos.node -> prev;
+                right = pos.node;
+            }
+            else{
+                if(pos.curPo < pos.node -> curLength){
+                    splitNode(pos.node, pos.curPo);
+                }
+                left = pos.node;
+                right = pos.node -> next;
+            }
+            if(right != NULL){
+                epoch++;
+            }
+            int leftBefore = (left == NULL ? 0 : left -> curLength);
+            nodeT *chain = NULL;
+            nodeT *last = NULL;
+            size_t cnt = 0;
+            try{
+                while(left != NULL && left -> curLength < nodeN && src.more()){
+                    src.build(left);
+                }
+                while(src.more()){
+                    nodeT *p = newNode();
+                    p -> prev = last;
+                    if(last != NULL){
+                        last -> next = p;
+                    }
+                    else{
+                        chain = p;
+                    }
+                    last = p;
+                    cnt++;
+                    while(p -> curLength < nodeN && src.more()){
+                        src.build(p);
+                    }
+                }
+            }
+            catch(...){
+                spliceChain(left, leftBefore, right, chain, last, cnt);
+                throw;
+            }
+            spliceChain(left, leftBefore, right, chain, last, cnt);
+            int offset;
+            nodeT *node = locate(index, offset);
+            return iterator(node, offset, this);
+        }
+        /**
+         * the bookkeeping half of insertFrom(): left grew from leftBefore elements,
+         * the cnt nodes chain ... last go between left and right.
+         */
+        void spliceChain(nodeT *left, int leftBefore, nodeT *right, nodeT *chain, nodeT *last, size_t cnt){
+            if(left != NULL){
+                resized(left, left -> curLength - leftBefore);
+                sizeDeq += left -> curLength - leftBefore;
+            }
+            if(last != NULL && last -> curLength == 0){
+                nodeT *p = last;
+                last = last -> prev;
+                if(last != NULL){
+                    last -> next = NULL;
+                }
+                else{
+                    chain = NULL;
+                }
+                freeNode(p);
+                cnt--;
+            }
+            if(chain != NULL){
+                nodeT *p;
+                for(p = chain; p != NULL; p = p -> next){
+                    sizeDeq += p -> curLength;
+                }
+                chain -> prev = left;
+                last -> next = right;
+                if(left != NULL){
+                    left -> next = chain;
+                }
+                else{
+                    head = chain;
+                }
+                if(right != NULL){
+                    right -> prev = last;
+                }
+                else{
+                    tail = last;
+                }
+                mapInsert(chain, left == NULL ? 0 : left -> idx + 1 - mapBegin, cnt);
+                if(right != NULL && last -> curLength + right -> curLength <= nodeN){
+                    int moved = right -> curLength;
+                    last -> appendFrom(right, moved);
+                    resized(last, moved);
+                    resized(right, -moved);
+                    unlink(right);
+                    right = NULL;
+                }
+                checkPacked(last);
+            }
+            if(left != NULL){
+                checkPacked(left);
+            }
+            if(right != NULL){
+                checkPacked(right);
+            }
+            // the split may leave short nodes on either side of the gap. each
+            // rebalance() only frees its node or the one after it, so go right to left.
+            int curPo = 0;
+            if(right != NULL){
+                rebalance(right, curPo);
+            }
+            if(last != NULL){
+                rebalance(last, curPo);
+            }
+            if(left != NULL){
+                rebalance(left, curPo);
+            }
         }
         /**
          * removes specified element at pos.
@@ -776,7 +2017,7 @@ namespace sjtu {
                 throw invalid_iterator();
             }
             
-            if(pos.curPo == 0 && pos.node == head -> next){
+            if(pos.curPo == 0 && pos.node == head){
                
                 pop_front();
                 return begin();
@@ -789,67 +2030,168 @@ namespace sjtu {
                 }
                 else{
                     sizeDeq--;
+                    epoch++;
                     if(pos.node -> curLength == 1){
                         
                         nodeT *p = pos.node;
-                        pos.node -> prev -> next = pos.node -> next;
-                        pos.node -> next -> prev = pos.node -> prev;
                         pos.setNode(pos.node -> next);
                         pos.curPo = 0;
-                        delete (p);  
+                        unlink(p);
                     }
                     else{
-                        if(pos.curPo == pos.node -> curLength - 1){
-                            
-                            delete pos.node -> arr[pos.curPo];                            
-                            pos.node -> curLength--;
+                        pos.node -> destroy(pos.curPo);
+                        pos.node -> closeSlot(pos.curPo);
+                        resized(pos.node, -1);
+                        checkPacked(pos.node);
+                        rebalance(pos.node, pos.curPo);
+                        if(pos.curPo == pos.node -> curLength && pos.node -> next != NULL){
                             pos.setNode(pos.node -> next);
                             pos.curPo = 0;
                         }
-                        else{
-                            
-                            int tmpPo = pos.curPo;
-                            delete pos.node -> arr[tmpPo];
-                            while(tmpPo != pos.node -> curLength - 1){
-                                pos.node -> arr[tmpPo] = pos.node -> arr[tmpPo + 1];
-                                tmpPo = tmpPo + 1;
-                            }
-                            pos.node -> curLength--;
-                        }
                     }
                     return pos; 
                 }
             }
         }
+        /**
+         * removes the elements in [first, last).
+         * returns an iterator following the last removed element.
+         * throw if an iterator is invalid or first is after last.
+         * the boundary nodes are trimmed and every node in between is freed whole,
+         * so the cost is the number of removed elements plus nodeN.
+         */
+        iterator erase(iterator first, iterator last){
+            int k;
+            if(this != first.deqId || this != last.deqId){
+                throw invalid_iterator();
+            }
+            if(first.node == NULL || last.node == NULL){
+                if(first.node != last.node){
+                    throw invalid_iterator();
+                }
+                return first;
+            }
+            if(first.curPo > first.node -> curLength || last.curPo > last.node -> curLength){
+                throw invalid_iterator();
+            }
+            long i = first - begin();
+            long j = last - begin();
+            if(i < 0 || j < i || j > sizeDeq){
+                throw invalid_iterator();
+            }
+            if(i == j){
+                nodeT *node = locate(i, k);
+                return iterator(node, k, this);
+            }
+            if(j - i == sizeDeq){
+                clear();
+                return end();
+            }
+            if(j != sizeDeq){
+                epoch++;
+            }
+            sizeDeq -= j - i;
+            // a position at the end of a node is the start of the next one and
+            // the other way round, so that [fo, fn) and [0, lo) of ln are not empty.
+            nodeT *fn = first.node;
+            nodeT *ln = last.node;
+            int fo = first.curPo;
+            int lo = last.curPo;
+            if(fo == fn -> curLength){
+                fn = fn -> next;
+                fo = 0;
+            }
+            if(lo == 0){
+                ln = ln -> prev;
+                lo = ln -> curLength;
+            }
+            if(fn == ln){
+                for(k = fo; k < lo; k++){
+                    fn -> destroy(k);
+                }
+                fn -> closeSlot(fo, lo - fo);
+                resized(fn, fo - lo);
+                if(fn -> curLength == 0){
+                    unlink(fn);
+                }
+                else{
+                    checkPacked(fn);
+                    rebalance(fn, k);
+                }
+            }
+            else{
+                for(k = fo; k < fn -> curLength; k++){
+                    fn -> destroy(k);
+                }
+                resized(fn, fo - fn -> curLength);
+                fn -> curLength = fo;
+                for(k = 0; k < lo; k++){
+                    ln -> destroy(k);
+                }
+                ln -> start = (ln -> start + lo) % nodeN;
+                ln -> curLength -= lo;
+                resized(ln, -lo);
+                nodeT *p = (fo == 0 ? fn : fn -> next);
+                nodeT *q = (ln -> curLength == 0 ? ln : ln -> prev);
+                if(fo == 0){
+                    fn = NULL;
+                }
+                if(ln -> curLength == 0){
+                    ln = NULL;
+                }
+                if(p -> idx <= q -> idx){
+                    unlink(p, q);
+                }
+                if(fn != NULL){
+                    checkPacked(fn);
+                }
+                if(ln != NULL){
+                    checkPacked(ln);
+                    rebalance(ln, k);
+                }
+                if(fn != NULL){
+                    rebalance(fn, k);
+                }
+            }
+            nodeT *node = locate(i, k);
+            return iterator(node, k, this);
+        }
         /**
          * adds an element to the end
          */
         void push_back(const T &value) {
-            
+            emplace_back(value);
+        }
+        void push_back(T &&value) {
+            emplace_back(std::move(value));
+        }
+        /**
+         * constructs an element from args in place at the end.
+         */
+        template<class... Args>
+        T &emplace_back(Args&&... args) {
+            if(tail == NULL){
+                initNode();
+            }
             if(sizeDeq == 0){
-                tail -> arr[0] = new T(value);
+                tail -> construct(0, std::forward<Args>(args)...);
                 tail -> curLength++;
+                resized(tail, 1);
                 sizeDeq++;
-                return;
+                return *(tail -> ptr(0));
             }
 
-            if(tail -> curLength >= nodeN / 2){
-                nodeT *p;
-                p = new nodeT;
-                p -> prev = tail;
-                p -> next = NULL;
-                tail -> next = p;
-                p -> arr[0] = new T(value);
-                p -> curLength = 1;
-                tail = p;
+            if(tail -> curLength == nodeN){
+                linkNew(tail, std::forward<Args>(args)...);
             }    
             else{
                 
+                tail -> construct(tail -> curLength, std::forward<Args>(args)...);
                 tail -> curLength++;
-                tail -> arr[tail -> curLength - 1] = new T(value);
+                resized(tail, 1);
             }
             sizeDeq++;
-        
+            return *(tail -> ptr(tail -> curLength - 1));
         }
         /**
          * removes the last element
@@ -862,63 +2204,61 @@ namespace sjtu {
             }
             sizeDeq--;          
             if(tail -> curLength == 1){
-                if(tail -> prev == head){
-                    delete tail -> arr[0];
+                if(tail -> prev == NULL){
+                    tail -> destroy(0);
                     tail -> curLength--;
+                    resized(tail, -1);
                 }
                 else{
                     
-                    nodeT *p = tail;
-                    tail = tail -> prev;
-                    tail -> next = NULL;
-                    delete p;
+                    unlink(tail);
                 }
 
             }
             else{
                 
-                delete tail -> arr[tail -> curLength - 1];
+                tail -> destroy(tail -> curLength - 1);
                 tail -> curLength--;
+                resized(tail, -1);
             }
         }
         /**
          * inserts an element to the beginning.
          */
         void push_front(const T &value) {
-            
+            emplace_front(value);
+        }
+        void push_front(T &&value) {
+            emplace_front(std::move(value));
+        }
+        /**
+         * constructs an element from args in place at the beginning.
+         */
+        template<class... Args>
+        T &emplace_front(Args&&... args) {
+            if(tail == NULL){
+                initNode();
+            }
             if(sizeDeq == 0){
-                tail -> arr[0] = new T(value);
+                tail -> construct(0, std::forward<Args>(args)...);
                 tail -> curLength++;
+                resized(tail, 1);
                 sizeDeq++;
-                return;
+                origin--;
+                return *(tail -> ptr(0));
             }
-            if(head -> next -> curLength >= nodeN / 2){
-               
-                nodeT *p;
-                p = new nodeT;
-                p -> next = head -> next;
-                head -> next -> prev = p;
-                head -> next = p;
-                p -> prev = head;
-                
-                p -> curLength = 1;
-                p -> arr[0] = new T(value);
+            if(head -> curLength == nodeN){
+                linkNew(NULL, std::forward<Args>(args)...);
             }
             else{
                
-                nodeT *startNode = head -> next;
-                int tmpCurPo = startNode -> curLength;
-
-                while(tmpCurPo != 0){
-                    startNode -> arr[tmpCurPo] = startNode -> arr[tmpCurPo - 1];
-                    tmpCurPo = tmpCurPo - 1;
-                }
-                startNode -> arr[tmpCurPo] = new T(value);
-                startNode -> curLength++;
+                nodeT *startNode = head;
+                startNode -> constructFront(std::forward<Args>(args)...);
+                resized(startNode, 1);
             }
             sizeDeq++;
-
-
+            origin--;
+            return *(head -> ptr(0));
         }
         /**
          * removes the first element.
@@ -931,32 +2271,1257 @@ namespace sjtu {
                 throw container_is_empty();
             }
             sizeDeq--;
-            nodeT *startNode = head -> next; 
+            origin++;
+            nodeT *startNode = head; 
             if(startNode -> curLength == 1){
                 if(startNode == tail){
-                    delete tail -> arr[0];
+                    tail -> destroy(0);
                     tail -> curLength--;
+                    resized(tail, -1);
                 }
                 else{
                    
-                    nodeT *p = startNode;
-                    p -> next -> prev = head;
-                    head -> next = p -> next;
-                    delete p;
+                    unlink(startNode);
                 }
             }
             else{
                 
-                int tmpPopPo = 0;
-                delete startNode -> arr[tmpPopPo];
-                while(tmpPopPo != startNode -> curLength - 1){
-                    startNode -> arr[tmpPopPo] =  startNode -> arr[tmpPopPo + 1];
-                    tmpPopPo += 1;
+                startNode -> destroy(0);
+                startNode -> closeSlot(0);
+                resized(startNode, -1);
+            }
+        }
+        /**
+         * moves up to n elements from the front into out and removes them,
+         * returns how many were moved. every node gives up its elements in at most
+         * two contiguous runs, emptied nodes are released once.
+         */
+        template<class OutputIt>
+        size_t pop_front_n(OutputIt out, size_t n) {
+            size_t done = 0;
+            while(done < n && sizeDeq != 0){
+                nodeT *p = head;
+                int c = p -> curLength;
+                if((size_t)c > n - done){
+                    c = n - done;
+                }
+                int k = 0;
+                while(k < c){
+                    int run = std::min(c - k, nodeN - p -> phys(k));
+                    T *first = p -> ptr(k);
+                    out = std::move(first, first + run, out);
+                    k += run;
+                }
+                p -> dropFront(c);
+                resized(p, -c);
+                sizeDeq -= c;
+                origin += c;
+                done += c;
+                if(p -> curLength == 0 && p != tail){
+                    unlink(p);
+                }
+            }
+            return done;
+        }
+        /**
+         * appends the n elements starting at first, returns first advanced past them.
+         * the tail is filled one contiguous run at a time (at most two per node) with
+         * the bookkeeping done per run; with the default allocator and a multi-pass
+         * source a run is a single uninitialized_copy_n, memmove for trivial T.
+         */
+        template<class InputIt>
+        InputIt push_back_n(InputIt first, size_t n) {
+            typedef typename std::iterator_traits<InputIt>::iterator_category category;
+            while(n != 0){
+                if(tail == NULL){
+                    initNode();
+                }
+                if(tail -> curLength == nodeN){
+                    linkAfter(tail, newNode());
+                }
+                int k = tail -> curLength;
+                int c = std::min(nodeN - k, nodeN - tail -> phys(k));
+                if((size_t)c > n){
+                    c = n;
+                }
+                first = fillRun(tail, k, c, first, std::is_base_of<std::forward_iterator_tag, category>());
+                resized(tail, c);
+                sizeDeq += c;
+                n -= c;
+            }
+            return first;
+        }
+        // build the c elements from first into the free, contiguous slots [k, k + c) of node.
+        template<class InputIt>
+        static InputIt fillRun(nodeT *node, int k, int c, InputIt first, std::true_type) {
+            if(!std::is_same<Allocator, std::allocator<T> >::value){
+                return fillRun(node, k, c, first, std::false_type());
+            }
+            std::uninitialized_copy_n(first, c, node -> ptr(k));
+            node -> curLength += c;
+            std::advance(first, c);
+            return first;
+        }
+        template<class InputIt>
+        static InputIt fillRun(nodeT *node, int k, int c, InputIt first, std::false_type) {
+            int i;
+            for(i = 0; i < c; i++){
+                node -> construct(k + i, *first);
+                node -> curLength++;
+                ++first;
+            }
+            return first;
+        }
+        /**
+         * move the first element into out and remove it.
+         * returns false, leaving out alone, if the container is empty; never throws on its own.
+         */
+        bool try_pop_front(T &out) {
+            if(sizeDeq == 0){
+                return false;
+            }
+            out = std::move(*(head -> ptr(0)));
+            pop_front();
+            return true;
+        }
+        /**
+         * move the last element into out and remove it.
+         * returns false, leaving out alone, if the container is empty.
+         */
+        bool try_pop_back(T &out) {
+            if(sizeDeq == 0){
+                return false;
+            }
+            out = std::move(*(tail -> ptr(tail -> curLength - 1)));
+            pop_back();
+            return true;
+        }
+        /**
+         * a pointer to the first element, or NULL if the container is empty.
+         */
+        T *try_front() {
+            return sizeDeq == 0 ? NULL : head -> ptr(0);
+        }
+        const T *try_front() const {
+            return sizeDeq == 0 ? NULL : head -> ptr(0);
+        }
+        /**
+         * a pointer to the last element, or NULL if the container is empty.
+         */
+        T *try_back() {
+            return sizeDeq == 0 ? NULL : tail -> ptr(tail -> curLength - 1);
+        }
+        const T *try_back() const {
+            return sizeDeq == 0 ? NULL : tail -> ptr(tail -> curLength - 1);
+        }
+        /**
+         * removes the first element and returns it, moved out.
+         * throw container_is_empty when the container is empty.
+         */
+        T pop_front_value() {
+            if(sizeDeq == 0){
+                throw container_is_empty();
+            }
+            T value(std::move(*(head -> ptr(0))));
+            pop_front();
+            return value;
+        }
+        /**
+         * removes the last element and returns it, moved out.
+         * throw container_is_empty when the container is empty.
+         */
+        T pop_back_value() {
+            if(sizeDeq == 0){
+                throw container_is_empty();
+            }
+            T value(std::move(*(tail -> ptr(tail -> curLength - 1))));
+            pop_back();
+            return value;
+        }
+        /**
+         * segmented traversal of [first, last), It being iterator or const_iterator:
+         * the range is cut into the contiguous runs of its nodes (at most two per node,
+         * the buffer being a ring) and f(b, e) is called on each run in order.
+         * f returns where it stopped in [b, e], anything but e ends the walk.
+         * returns the iterator at which f stopped, or last.
+         */
+        template<class It, class F>
+        static It segmentWalk(It first, It last, F &&f) {
+            typedef typename It::pointer ptrT;
+            CheckPolicy::template require<invalid_iterator>(first.deqId == last.deqId);
+            segment_iterator<ptrT> s(first.node, first.curPo, last.node, last.curPo);
+            for(; s.node != NULL; ++s){
+                ptrT b = s -> data;
+                ptrT r = f(b, b + s -> len);
+                if(r != b + s -> len){
+                    return It(s.node, s.curPo + int(r - b), first.deqId);
+                }
+            }
+            return last;
+        }
+        /**
+         * how many nodes [first, last) touches, the nodes being numbered by their map slots.
+         */
+        template<class It>
+        static size_t nodeSpan(const It &first, const It &last) {
+            if(first == last){
+                return 0;
+            }
+            return last.node -> idx - first.node -> idx + 1;
+        }
+        /**
+         * where the k-th node of [first, last) starts: first for k == 0, last once past its node.
+         */
+        template<class It>
+        static It nodeCut(const It &first, const It &last, size_t k) {
+            if(k == 0){
+                return first;
+            }
+            size_t i = first.node -> idx + k;
+            if(i > last.node -> idx){
+                return last;
+            }
+            return It(first.deqId -> mapArr[i], 0, first.deqId);
+        }
+    };
+
+
+    template<class T, int nodeN, class Allocator, class CheckPolicy>
+    void swap(deque<T, nodeN, Allocator, CheckPolicy> &lhs, deque<T, nodeN, Allocator, CheckPolicy> &rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+#ifdef SJTU_DEQUE_HAS_PMR
+    namespace pmr {
+        /**
+         * a deque drawing all of its memory from a std::pmr::memory_resource.
+         */
+        template<class T, int nodeN = deque_block_size<T>::value, class CheckPolicy = checked>
+        using deque = sjtu::deque<T, nodeN, std::pmr::polymorphic_allocator<T>, CheckPolicy>;
+    }
+#endif
+
+    /**
+     * find, count, min_element, max_element and sum over plain arrays, vectorised for
+     * int, float and double with SSE2 or AVX2, whichever the cpu has (asked once, via cpuid),
+     * and plain loops for every other type, every other cpu, or SJTU_DEQUE_NO_SIMD.
+     * the results are those of the std algorithms, except that sum adds in another order,
+     * which a floating-point sum can notice.
+     */
+    namespace simd {
+        enum level_t{
+            level_scalar = 0,
+            level_sse2 = 1,
+            level_avx2 = 2
+        };
+        // the best level this cpu supports.
+        inline int detectLevel(){
+#ifdef SJTU_DEQUE_SIMD_X86
+            __builtin_cpu_init();
+            if(__builtin_cpu_supports("avx2")){
+                return level_avx2;
+            }
+            return level_sse2;
+#else
+            return level_scalar;
+#endif
+        }
+        inline int &levelRef(){
+            static int lv = detectLevel();
+            return lv;
+        }
+        /**
+         * the level the kernels run at.
+         */
+        inline int level(){
+            return levelRef();
+        }
+        /**
+         * run the kernels at level lv, or at the best the cpu supports if that is lower;
+         * returns the level now in use. not meant to race with running kernels.
+         */
+        inline int set_level(int lv){
+            int best = detectLevel();
+            levelRef() = lv < level_scalar ? level_scalar : (lv > best ? best : lv);
+            return levelRef();
+        }
+
+        /**
+         * what sum(b, e) adds into: long long (unsigned long long) for integers,
+         * the type itself for floating point.
+         */
+        template<class T, bool = std::is_integral<T>::value>
+        struct sum_type{
+            typedef typename std::conditional<std::is_signed<T>::value, long long, unsigned long long>::type type;
+        };
+        template<class T>
+        struct sum_type<T, false>{
+            typedef T type;
+        };
+
+        template<class T>
+        const T *scalarFind(const T *b, const T *e, const T &value){
+            for(; b != e; ++b){
+                if(*b == value){
+                    return b;
                 }
-                startNode -> curLength--;
             }
+            return e;
+        }
+        template<class T>
+        size_t scalarCount(const T *b, const T *e, const T &value){
+            size_t cnt = 0;
+            for(; b != e; ++b){
+                cnt += *b == value;
+            }
+            return cnt;
+        }
+        // the element std::min_element (Max: max_element) would settle on when started at best.
+        template<bool Max, class T>
+        const T *scalarExtreme(const T *b, const T *e, const T *best){
+            for(; b != e; ++b){
+                if(Max ? *best < *b : *b < *best){
+                    best = b;
+                }
+            }
+            return best;
+        }
+        template<class T>
+        typename sum_type<T>::type scalarSum(const T *b, const T *e){
+            typename sum_type<T>::type s = 0;
+            for(; b != e; ++b){
+                s += *b;
+            }
+            return s;
+        }
+
+#ifdef SJTU_DEQUE_SIMD_X86
+        /**
+         * one instruction set's worth of lanes: ops<T> wraps the intrinsics for T,
+         * the kernels below are written once against it. the kernels only run after
+         * the level check, so the avx2 copy may use instructions the baseline lacks.
+         */
+#define SJTU_DEQUE_SIMD_KERNELS \
+        template<class Ops, class T> \
+        const T *find(const T *b, const T *e, const T &value){ \
+            typename Ops::V s = Ops::splat(value); \
+            for(; e - b >= Ops::W; b += Ops::W){ \
+                int m = Ops::eqMask(Ops::load(b), s); \
+                if(m != 0){ \
+                    return b + __builtin_ctz(m); \
+                } \
+            } \
+            return scalarFind(b, e, value); \
+        } \
+        template<class Ops, class T> \
+        size_t count(const T *b, const T *e, const T &value){ \
+            typename Ops::V s = Ops::splat(value); \
+            size_t cnt = 0; \
+            while(e - b >= Ops::W){ \
+                /* lane counters are flushed before they can overflow. */ \
+                const T *stop = e - b >= (1L << 24) * Ops::W ? b + (1L << 24) * Ops::W : e; \
+                typename Ops::C acc = Ops::cntZero(); \
+                for(; stop - b >= Ops::W; b += Ops::W){ \
+                    acc = Ops::cntAdd(acc, Ops::load(b), s); \
+                } \
+                cnt += Ops::cntReduce(acc); \
+            } \
+            return cnt + scalarCount(b, e, value); \
+        } \
+        template<bool Max, class Ops, class T> \
+        const T *extreme(const T *b, const T *e, const T *best){ \
+            if(e - b < Ops::W){ \
+                return scalarExtreme<Max>(b, e, best); \
+            } \
+            typename Ops::V m = Ops::load(b); \
+            typename Ops::V nan = Ops::nanAcc(Ops::zero(), m); \
+            const T *p = b + Ops::W; \
+            for(; e - p >= Ops::W; p += Ops::W){ \
+                typename Ops::V x = Ops::load(p); \
+                nan = Ops::nanAcc(nan, x); \
+                m = Max ? Ops::max(m, x) : Ops::min(m, x); \
+            } \
+            if(Ops::any(nan)){ \
+                return scalarExtreme<Max>(b, e, best); \
+            } \
+            T lanes[Ops::W]; \
+            Ops::store(lanes, m); \
+            T r = lanes[0]; \
+            for(int i = 1; i < Ops::W; i++){ \
+                r = (Max ? r < lanes[i] : lanes[i] < r) ? lanes[i] : r; \
+            } \
+            for(; p != e; ++p){ \
+                if(*p != *p){ \
+                    return scalarExtreme<Max>(b, e, best); \
+                } \
+                r = (Max ? r < *p : *p < r) ? *p : r; \
+            } \
+            if(Max ? *best < r : r < *best){ \
+                return find<Ops>(b, e, r); \
+            } \
+            return best; \
+        } \
+        template<class Ops, class T> \
+        typename sum_type<T>::type sum(const T *b, const T *e){ \
+            typename Ops::S acc = Ops::sumZero(); \
+            for(; e - b >= Ops::W; b += Ops::W){ \
+                acc = Ops::sumAdd(acc, Ops::load(b)); \
+            } \
+            return Ops::sumReduce(acc) + scalarSum(b, e); \
         }
+
+        namespace sse2 {
+            template<class T>
+            struct ops;
+            template<>
+            struct ops<int>{
+                typedef __m128i V;
+                typedef __m128i S;
+                enum { W = 4 };
+                static V load(const int *p){ return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+                static void store(int *p, V x){ _mm_storeu_si128(reinterpret_cast<__m128i *>(p), x); }
+                static V splat(int v){ return _mm_set1_epi32(v); }
+                static V zero(){ return _mm_setzero_si128(); }
+                static int eqMask(V a, V b){ return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b))); }
+                static V min(V a, V b){
+                    V gt = _mm_cmpgt_epi32(a, b);
+                    return _mm_or_si128(_mm_and_si128(gt, b), _mm_andnot_si128(gt, a));
+                }
+                static V max(V a, V b){
+                    V gt = _mm_cmpgt_epi32(a, b);
+                    return _mm_or_si128(_mm_and_si128(gt, a), _mm_andnot_si128(gt, b));
+                }
+                static V nanAcc(V acc, V){ return acc; }
+                static bool any(V){ return false; }
+                // a match is -1 in its lane, subtracted from a counter per lane.
+                typedef __m128i C;
+                static C cntZero(){ return _mm_setzero_si128(); }
+                static C cntAdd(C acc, V a, V b){ return _mm_sub_epi32(acc, _mm_cmpeq_epi32(a, b)); }
+                static size_t cntReduce(C acc){ return reduce32(acc); }
+                static size_t reduce32(__m128i acc){
+                    unsigned int l[4];
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(l), acc);
+                    return (size_t)l[0] + l[1] + l[2] + l[3];
+                }
+                // the four ints are sign-extended and added into two 64-bit lanes.
+                static S sumZero(){ return _mm_setzero_si128(); }
+                static S sumAdd(S acc, V x){
+                    V sign = _mm_srai_epi32(x, 31);
+                    acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(x, sign));
+                    return _mm_add_epi64(acc, _mm_unpackhi_epi32(x, sign));
+                }
+                static long long sumReduce(S acc){
+                    long long l[2];
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(l), acc);
+                    return l[0] + l[1];
+                }
+            };
+            template<>
+            struct ops<float>{
+                typedef __m128 V;
+                typedef __m128 S;
+                enum { W = 4 };
+                static V load(const float *p){ return _mm_loadu_ps(p); }
+                static void store(float *p, V x){ _mm_storeu_ps(p, x); }
+                static V splat(float v){ return _mm_set1_ps(v); }
+                static V zero(){ return _mm_setzero_ps(); }
+                static int eqMask(V a, V b){ return _mm_movemask_ps(_mm_cmpeq_ps(a, b)); }
+                static V min(V a, V b){ return _mm_min_ps(a, b); }
+                static V max(V a, V b){ return _mm_max_ps(a, b); }
+                static V nanAcc(V acc, V x){ return _mm_or_ps(acc, _mm_cmpunord_ps(x, x)); }
+                static bool any(V acc){ return _mm_movemask_ps(acc) != 0; }
+                typedef __m128i C;
+                static C cntZero(){ return _mm_setzero_si128(); }
+                static C cntAdd(C acc, V a, V b){ return _mm_sub_epi32(acc, _mm_castps_si128(_mm_cmpeq_ps(a, b))); }
+                static size_t cntReduce(C acc){ return ops<int>::reduce32(acc); }
+                static S sumZero(){ return _mm_setzero_ps(); }
+                static S sumAdd(S acc, V x){ return _mm_add_ps(acc, x); }
+                static float sumReduce(S acc){
+                    float l[4];
+                    _mm_storeu_ps(l, acc);
+                    return (l[0] + l[1]) + (l[2] + l[3]);
+                }
+            };
+            template<>
+            struct ops<double>{
+                typedef __m128d V;
+                typedef __m128d S;
+                enum { W = 2 };
+                static V load(const double *p){ return _mm_loadu_pd(p); }
+                static void store(double *p, V x){ _mm_storeu_pd(p, x); }
+                static V splat(double v){ return _mm_set1_pd(v); }
+                static V zero(){ return _mm_setzero_pd(); }
+                static int eqMask(V a, V b){ return _mm_movemask_pd(_mm_cmpeq_pd(a, b)); }
+                static V min(V a, V b){ return _mm_min_pd(a, b); }
+                static V max(V a, V b){ return _mm_max_pd(a, b); }
+                static V nanAcc(V acc, V x){ return _mm_or_pd(acc, _mm_cmpunord_pd(x, x)); }
+                static bool any(V acc){ return _mm_movemask_pd(acc) != 0; }
+                typedef __m128i C;
+                static C cntZero(){ return _mm_setzero_si128(); }
+                static C cntAdd(C acc, V a, V b){ return _mm_sub_epi64(acc, _mm_castpd_si128(_mm_cmpeq_pd(a, b))); }
+                static size_t cntReduce(C acc){
+                    unsigned long long l[2];
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(l), acc);
+                    return l[0] + l[1];
+                }
+                static S sumZero(){ return _mm_setzero_pd(); }
+                static S sumAdd(S acc, V x){ return _mm_add_pd(acc, x); }
+                static double sumReduce(S acc){
+                    double l[2];
+                    _mm_storeu_pd(l, acc);
+                    return l[0] + l[1];
+                }
+            };
+            SJTU_DEQUE_SIMD_KERNELS
+        }
+
+#ifdef __clang__
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+        namespace avx2 {
+            template<class T>
+            struct ops;
+            template<>
+            struct ops<int>{
+                typedef __m256i V;
+                typedef __m256i S;
+                enum { W = 8 };
+                static V load(const int *p){ return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+                static void store(int *p, V x){ _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), x); }
+                static V splat(int v){ return _mm256_set1_epi32(v); }
+                static V zero(){ return _mm256_setzero_si256(); }
+                static int eqMask(V a, V b){ return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b))); }
+                static V min(V a, V b){ return _mm256_min_epi32(a, b); }
+                static V max(V a, V b){ return _mm256_max_epi32(a, b); }
+                static V nanAcc(V acc, V){ return acc; }
+                static bool any(V){ return false; }
+                typedef __m256i C;
+                static C cntZero(){ return _mm256_setzero_si256(); }
+                static C cntAdd(C acc, V a, V b){ return _mm256_sub_epi32(acc, _mm256_cmpeq_epi32(a, b)); }
+                static size_t cntReduce(C acc){ return reduce32(acc); }
+                static size_t reduce32(__m256i acc){
+                    unsigned int l[8];
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(l), acc);
+                    return (size_t)l[0] + l[1] + l[2] + l[3] + l[4] + l[5] + l[6] + l[7];
+                }
+                static S sumZero(){ return _mm256_setzero_si256(); }
+                static S sumAdd(S acc, V x){
+                    acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(x)));
+                    return _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(x, 1)));
+                }
+                static long long sumReduce(S acc){
+                    long long l[4];
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(l), acc);
+                    return (l[0] + l[1]) + (l[2] + l[3]);
+                }
+            };
+            template<>
+            struct ops<float>{
+                typedef __m256 V;
+                typedef __m256 S;
+                enum { W = 8 };
+                static V load(const float *p){ return _mm256_loadu_ps(p); }
+                static void store(float *p, V x){ _mm256_storeu_ps(p, x); }
+                static V splat(float v){ return _mm256_set1_ps(v); }
+                static V zero(){ return _mm256_setzero_ps(); }
+                static int eqMask(V a, V b){ return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)); }
+                static V min(V a, V b){ return _mm256_min_ps(a, b); }
+                static V max(V a, V b){ return _mm256_max_ps(a, b); }
+                static V nanAcc(V acc, V x){ return _mm256_or_ps(acc, _mm256_cmp_ps(x, x, _CMP_UNORD_Q)); }
+                static bool any(V acc){ return _mm256_movemask_ps(acc) != 0; }
+                typedef __m256i C;
+                static C cntZero(){ return _mm256_setzero_si256(); }
+                static C cntAdd(C acc, V a, V b){ return _mm256_sub_epi32(acc, _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_EQ_OQ))); }
+                static size_t cntReduce(C acc){ return ops<int>::reduce32(acc); }
+                static S sumZero(){ return _mm256_setzero_ps(); }
+                static S sumAdd(S acc, V x){ return _mm256_add_ps(acc, x); }
+                static float sumReduce(S acc){
+                    float l[8];
+                    _mm256_storeu_ps(l, acc);
+                    return ((l[0] + l[1]) + (l[2] + l[3])) + ((l[4] + l[5]) + (l[6] + l[7]));
+                }
+            };
+            template<>
+            struct ops<double>{
+                typedef __m256d V;
+                typedef __m256d S;
+                enum { W = 4 };
+                static V load(const double *p){ return _mm256_loadu_pd(p); }
+                static void store(double *p, V x){ _mm256_storeu_pd(p, x); }
+                static V splat(double v){ return _mm256_set1_pd(v); }
+                static V zero(){ return _mm256_setzero_pd(); }
+                static int eqMask(V a, V b){ return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)); }
+                static V min(V a, V b){ return _mm256_min_pd(a, b); }
+                static V max(V a, V b){ return _mm256_max_pd(a, b); }
+                static V nanAcc(V acc, V x){ return _mm256_or_pd(acc, _mm256_cmp_pd(x, x, _CMP_UNORD_Q)); }
+                static bool any(V acc){ return _mm256_movemask_pd(acc) != 0; }
+                typedef __m256i C;
+                static C cntZero(){ return _mm256_setzero_si256(); }
+                static C cntAdd(C acc, V a, V b){ return _mm256_sub_epi64(acc, _mm256_castpd_si256(_mm256_cmp_pd(a, b, _CMP_EQ_OQ))); }
+                static size_t cntReduce(C acc){
+                    unsigned long long l[4];
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(l), acc);
+                    return (l[0] + l[1]) + (l[2] + l[3]);
+                }
+                static S sumZero(){ return _mm256_setzero_pd(); }
+                static S sumAdd(S acc, V x){ return _mm256_add_pd(acc, x); }
+                static double sumReduce(S acc){
+                    double l[4];
+                    _mm256_storeu_pd(l, acc);
+                    return (l[0] + l[1]) + (l[2] + l[3]);
+                }
+            };
+            SJTU_DEQUE_SIMD_KERNELS
+        }
+#ifdef __clang__
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+#undef SJTU_DEQUE_SIMD_KERNELS
+
+        template<class T>
+        struct has_kernels : std::integral_constant<bool, std::is_same<T, int>::value || std::is_same<T, float>::value || std::is_same<T, double>::value> {};
+#else
+        template<class T>
+        struct has_kernels : std::false_type {};
+#endif
+
+        // kernel dispatch: ops<T> exists only for the types has_kernels lets through.
+        template<class T>
+        const T *findIn(const T *b, const T *e, const T &value, std::false_type){
+            return scalarFind(b, e, value);
+        }
+        template<class T>
+        size_t countIn(const T *b, const T *e, const T &value, std::false_type){
+            return scalarCount(b, e, value);
+        }
+        template<bool Max, class T>
+        const T *extremeIn(const T *b, const T *e, const T *best, std::false_type){
+            return scalarExtreme<Max>(b, e, best);
+        }
+        template<class T>
+        typename sum_type<T>::type sumIn(const T *b, const T *e, std::false_type){
+            return scalarSum(b, e);
+        }
+#ifdef SJTU_DEQUE_SIMD_X86
+        template<class T>
+        const T *findIn(const T *b, const T *e, const T &value, std::true_type){
+            switch(level()){
+                case level_avx2: return avx2::find<avx2::ops<T> >(b, e, value);
+                case level_sse2: return sse2::find<sse2::ops<T> >(b, e, value);
+                default: return scalarFind(b, e, value);
+            }
+        }
+        template<class T>
+        size_t countIn(const T *b, const T *e, const T &value, std::true_type){
+            switch(level()){
+                case level_avx2: return avx2::count<avx2::ops<T> >(b, e, value);
+                case level_sse2: return sse2::count<sse2::ops<T> >(b, e, value);
+                default: return scalarCount(b, e, value);
+            }
+        }
+        template<bool Max, class T>
+        const T *extremeIn(const T *b, const T *e, const T *best, std::true_type){
+            switch(level()){
+                case level_avx2: return avx2::extreme<Max, avx2::ops<T> >(b, e, best);
+                case level_sse2: return sse2::extreme<Max, sse2::ops<T> >(b, e, best);
+                default: return scalarExtreme<Max>(b, e, best);
+            }
+        }
+        template<class T>
+        typename sum_type<T>::type sumIn(const T *b, const T *e, std::true_type){
+            switch(level()){
+                case level_avx2: return avx2::sum<avx2::ops<T> >(b, e);
+                case level_sse2: return sse2::sum<sse2::ops<T> >(b, e);
+                default: return scalarSum(b, e);
+            }
+        }
+#endif
+
+        /**
+         * the first element of [b, e) equal to value, or e.
+         */
+        template<class T>
+        const T *find(const T *b, const T *e, const T &value){
+            return findIn(b, e, value, has_kernels<T>());
+        }
+        /**
+         * how many elements of [b, e) equal value.
+         */
+        template<class T>
+        size_t count(const T *b, const T *e, const T &value){
+            return countIn(b, e, value, has_kernels<T>());
+        }
+        /**
+         * the first smallest element of [b, e), or e if it is empty, as std::min_element.
+         */
+        template<class T>
+        const T *min_element(const T *b, const T *e){
+            return b == e ? e : extremeIn<false>(b + 1, e, b, has_kernels<T>());
+        }
+        /**
+         * the first largest element of [b, e), or e if it is empty, as std::max_element.
+         */
+        template<class T>
+        const T *max_element(const T *b, const T *e){
+            return b == e ? e : extremeIn<true>(b + 1, e, b, has_kernels<T>());
+        }
+        /**
+         * the sum of [b, e), in sum_type<T>.
+         */
+        template<class T>
+        typename sum_type<T>::type sum(const T *b, const T *e){
+            return sumIn(b, e, has_kernels<T>());
+        }
+    }
+
+    template<class...>
+    struct segmented_void{
+        typedef void type;
     };
+    /**
+     * whether It is a deque iterator, whose ranges the algorithms below walk node by node.
+     */
+    template<class It, class = void>
+    struct is_segmented_iterator : std::false_type {};
+    template<class It>
+    struct is_segmented_iterator<It, typename segmented_void<typename It::segmented_deque>::type> : std::true_type {};
+
+    /**
+     * segment-aware algorithms, after Austern's segmented iterators.
+     * each behaves as its std namesake. when the (first) range is a deque range
+     * the inner loop runs over raw pointers, one contiguous run at a time,
+     * instead of paying iterator::operator++ per element; any other range is
+     * handed to the std algorithm.
+     * they live in sjtu::segmented, which argument-dependent lookup never searches,
+     * so an unqualified find(q.begin(), q.end(), x) still means std::find.
+     */
+    namespace segmented {
+        // a single run; arrays of T searched for a T go through the simd kernels.
+        template<class P, class V>
+        P findRun(P b, P e, const V &value) {
+            return std::find(b, e, value);
+        }
+        template<class T>
+        T *findRun(T *b, T *e, const T &value) {
+            return b + (simd::find<T>(b, e, value) - b);
+        }
+        template<class T>
+        const T *findRun(const T *b, const T *e, const T &value) {
+            return simd::find(b, e, value);
+        }
+        template<class P, class V>
+        long int countRun(P b, P e, const V &value) {
+            return std::count(b, e, value);
+        }
+        template<class T>
+        long int countRun(T *b, T *e, const T &value) {
+            return simd::count<T>(b, e, value);
+        }
+        template<class T>
+        long int countRun(const T *b, const T *e, const T &value) {
+            return simd::count(b, e, value);
+        }
+
+        template<class It, class F>
+        F forEachIn(It first, It last, F f, std::true_type) {
+            It::segmented_deque::segmentWalk(first, last, [&f](typename It::pointer b, typename It::pointer e){
+                for(typename It::pointer i = b; i != e; ++i){
+                    f(*i);
+                }
+                return e;
+            });
+            return f;
+        }
+        template<class It, class F>
+        F forEachIn(It first, It last, F f, std::false_type) {
+            return std::for_each(first, last, std::move(f));
+        }
+
+        template<class It, class OutputIt>
+        OutputIt copyIn(It first, It last, OutputIt out, std::true_type) {
+            It::segmented_deque::segmentWalk(first, last, [&out](typename It::pointer b, typename It::pointer e){
+                out = std::copy(b, e, out);
+                return e;
+            });
+            return out;
+        }
+        template<class It, class OutputIt>
+        OutputIt copyIn(It first, It last, OutputIt out, std::false_type) {
+            return std::copy(first, last, out);
+        }
+
+        template<class It, class V>
+        void fillIn(It first, It last, const V &value, std::true_type) {
+            It::segmented_deque::segmentWalk(first, last, [&value](typename It::pointer b, typename It::pointer e){
+                std::fill(b, e, value);
+                return e;
+            });
+        }
+        template<class It, class V>
+        void fillIn(It first, It last, const V &value, std::false_type) {
+            std::fill(first, last, value);
+        }
+
+        template<class It, class V>
+        It findIn(It first, It last, const V &value, std::true_type) {
+            return It::segmented_deque::segmentWalk(first, last, [&value](typename It::pointer b, typename It::pointer e){
+                return findRun(b, e, value);
+            });
+        }
+        template<class It, class V>
+        It findIn(It first, It last, const V &value, std::false_type) {
+            return std::find(first, last, value);
+        }
+
+        template<class It, class V>
+        typename std::iterator_traits<It>::difference_type countIn(It first, It last, const V &value, std::true_type) {
+            typename std::iterator_traits<It>::difference_type cnt = 0;
+            It::segmented_deque::segmentWalk(first, last, [&cnt, &value](typename It::pointer b, typename It::pointer e){
+                cnt += countRun(b, e, value);
+                return e;
+            });
+            return cnt;
+        }
+        template<class It, class V>
+        typename std::iterator_traits<It>::difference_type countIn(It first, It last, const V &value, std::false_type) {
+            return std::count(first, last, value);
+        }
+
+        template<class It, class V, class Op>
+        V accumulateIn(It first, It last, V init, Op op, std::true_type) {
+            It::segmented_deque::segmentWalk(first, last, [&init, &op](typename It::pointer b, typename It::pointer e){
+                init = std::accumulate(b, e, std::move(init), op);
+                return e;
+            });
+            return init;
+        }
+        template<class It, class V, class Op>
+        V accumulateIn(It first, It last, V init, Op op, std::false_type) {
+            return std::accumulate(first, last, std::move(init), op);
+        }
+
+        template<class It, class It2, class Pred>
+        bool equalIn(It first1, It last1, It2 first2, Pred pred, std::true_type) {
+            It stop = It::segmented_deque::segmentWalk(first1, last1, [&first2, &pred](typename It::pointer b, typename It::pointer e){
+                std::pair<typename It::pointer, It2> r = std::mismatch(b, e, first2, pred);
+                first2 = r.second;
+                return r.first;
+            });
+            return stop == last1;
+        }
+        template<class It, class It2, class Pred>
+        bool equalIn(It first1, It last1, It2 first2, Pred pred, std::false_type) {
+            return std::equal(first1, last1, first2, pred);
+        }
+
+        template<class It, class OutputIt, class Op>
+        OutputIt transformIn(It first, It last, OutputIt out, Op op, std::true_type) {
+            It::segmented_deque::segmentWalk(first, last, [&out, &op](typename It::pointer b, typename It::pointer e){
+                out = std::transform(b, e, out, op);
+                return e;
+            });
+            return out;
+        }
+        template<class It, class OutputIt, class Op>
+        OutputIt transformIn(It first, It last, OutputIt out, Op op, std::false_type) {
+            return std::transform(first, last, out, op);
+        }
+
+        template<bool Max, class It>
+        It extremeIn(It first, It last, std::true_type) {
+            typedef typename It::value_type T;
+            const T *best = NULL;
+            long int at = 0, pos = 0;
+            It::segmented_deque::segmentWalk(first, last, [&](typename It::pointer b, typename It::pointer e){
+                const T *from = b;
+                if(best == NULL){
+                    best = b;
+                    from = b + 1;
+                }
+                const T *r = simd::extremeIn<Max>(from, (const T *)e, best, simd::has_kernels<T>());
+                if(r != best){
+                    best = r;
+                    at = pos + (r - b);
+                }
+                pos += e - b;
+                return e;
+            });
+            return best == NULL ? last : first + at;
+        }
+        template<bool Max, class It>
+        It extremeIn(It first, It last, std::false_type) {
+            return Max ? std::max_element(first, last) : std::min_element(first, last);
+        }
+
+        template<class It>
+        typename simd::sum_type<typename std::iterator_traits<It>::value_type>::type sumIn(It first, It last, std::true_type) {
+            typedef typename It::value_type T;
+            typename simd::sum_type<T>::type s = 0;
+            It::segmented_deque::segmentWalk(first, last, [&s](typename It::pointer b, typename It::pointer e){
+                s += simd::sum<T>(b, e);
+                return e;
+            });
+            return s;
+        }
+        template<class It>
+        typename simd::sum_type<typename std::iterator_traits<It>::value_type>::type sumIn(It first, It last, std::false_type) {
+            typename simd::sum_type<typename std::iterator_traits<It>::value_type>::type s = 0;
+            for(; first != last; ++first){
+                s += *first;
+            }
+            return s;
+        }
+
+        struct equalTo{
+            template<class A, class B>
+            bool operator()(const A &a, const B &b) const {
+                return a == b;
+            }
+        };
+        struct plus{
+            template<class A, class B>
+            A operator()(const A &a, const B &b) const {
+                return a + b;
+            }
+        };
+
+        template<class It, class F>
+        F for_each(It first, It last, F f) {
+            return forEachIn(first, last, std::move(f), is_segmented_iterator<It>());
+        }
+        template<class It, class OutputIt>
+        OutputIt copy(It first, It last, OutputIt out) {
+            return copyIn(first, last, out, is_segmented_iterator<It>());
+        }
+        template<class It, class V>
+        void fill(It first, It last, const V &value) {
+            fillIn(first, last, value, is_segmented_iterator<It>());
+        }
+        template<class It, class V>
+        It find(It first, It last, const V &value) {
+            return findIn(first, last, value, is_segmented_iterator<It>());
+        }
+        template<class It, class V>
+        typename std::iterator_traits<It>::difference_type count(It first, It last, const V &value) {
+            return countIn(first, last, value, is_segmented_iterator<It>());
+        }
+        template<class It, class V>
+        V accumulate(It first, It last, V init) {
+            return accumulateIn(first, last, std::move(init), plus(), is_segmented_iterator<It>());
+        }
+        template<class It, class V, class Op>
+        V accumulate(It first, It last, V init, Op op) {
+            return accumulateIn(first, last, std::move(init), op, is_segmented_iterator<It>());
+        }
+        template<class It, class It2>
+        bool equal(It first1, It last1, It2 first2) {
+            return equalIn(first1, last1, first2, equalTo(), is_segmented_iterator<It>());
+        }
+        template<class It, class It2, class Pred>
+        bool equal(It first1, It last1, It2 first2, Pred pred) {
+            return equalIn(first1, last1, first2, pred, is_segmented_iterator<It>());
+        }
+        template<class It, class OutputIt, class Op>
+        OutputIt transform(It first, It last, OutputIt out, Op op) {
+            return transformIn(first, last, out, op, is_segmented_iterator<It>());
+        }
+        /**
+         * the first smallest (largest) element, as std::min_element (max_element);
+         * over a deque of int, float or double each run goes through the simd kernels.
+         */
+        template<class It>
+        It min_element(It first, It last) {
+            return extremeIn<false>(first, last, is_segmented_iterator<It>());
+        }
+        template<class It>
+        It max_element(It first, It last) {
+            return extremeIn<true>(first, last, is_segmented_iterator<It>());
+        }
+        /**
+         * the sum of [first, last) in simd::sum_type, so a deque<int> sums without overflow.
+         */
+        template<class It>
+        typename simd::sum_type<typename std::iterator_traits<It>::value_type>::type sum(It first, It last) {
+            return sumIn(first, last, is_segmented_iterator<It>());
+        }
+    }
+
+#ifndef SJTU_DEQUE_NO_THREADS
+    /**
+     * parallel for_each, transform and reduce over deque ranges. the range is cut at
+     * node boundaries into at most taskLimit groups of whole nodes, one task per group,
+     * and the tasks run on a thread_pool (thread_pool::instance() unless one is given).
+     * the cut depends only on the range, never on the number of threads, and reduce
+     * combines the groups left to right, so its result is the same on any machine.
+     * an exception thrown by a task is rethrown in the caller once all tasks are done.
+     */
+    namespace parallel {
+        /**
+         * a small work-stealing pool: every worker owns a deque of tasks, runs its own
+         * newest task first and, when out of work, steals the oldest task of another.
+         * a thread waiting for its tasks runs queued tasks meanwhile, so the
+         * algorithms may be called from inside a task.
+         */
+        class thread_pool{
+            typedef std::function<void()> taskT;
+            struct workerT{
+                std::mutex lock;
+                deque<taskT> tasks;
+            };
+            struct slotT{
+                const thread_pool *pool;
+                size_t id;
+            };
+            workerT *workers;
+            size_t workerCnt;
+            std::vector<std::thread> threads;
+            std::mutex sleepLock;
+            std::condition_variable wake;
+            std::atomic<size_t> pending;
+            std::atomic<size_t> nextWorker;
+            bool stopping;
+
+            // which worker of which pool the calling thread is.
+            static slotT &self(){
+                static thread_local slotT slot = {NULL, 0};
+                return slot;
+            }
+            // pop a task, own queue first, and run it; false if every queue was empty.
+            bool runOne(){
+                slotT &me = self();
+                size_t first = me.pool == this ? me.id : 0;
+                for(size_t i = 0; i < workerCnt; i++){
+                    workerT &w = workers[(first + i) % workerCnt];
+                    taskT task;
+                    bool got;
+                    {
+                        std::lock_guard<std::mutex> guard(w.lock);
+                        got = (me.pool == this && i == 0) ? w.tasks.try_pop_back(task) : w.tasks.try_pop_front(task);
+                    }
+                    if(got){
+                        pending--;
+                        task();
+                        return true;
+                    }
+                }
+                return false;
+            }
+            void workerLoop(size_t id){
+                self().pool = this;
+                self().id = id;
+                while(true){
+                    if(runOne()){
+                        continue;
+                    }
+                    std::unique_lock<std::mutex> guard(sleepLock);
+                    wake.wait(guard, [this]{ return stopping || pending != 0; });
+                    if(stopping && pending == 0){
+                        return;
+                    }
+                }
+            }
+        public:
+            /**
+             * a pool of n workers, one per hardware thread by default.
+             */
+            explicit thread_pool(size_t n = 0) : pending(0), nextWorker(0), stopping(false) {
+                if(n == 0){
+                    n = std::thread::hardware_concurrency();
+                }
+                if(n == 0){
+                    n = 1;
+                }
+                workerCnt = n;
+                workers = new workerT[n];
+                size_t i;
+                for(i = 0; i < n; i++){
+                    threads.push_back(std::thread(&thread_pool::workerLoop, this, i));
+                }
+            }
+            thread_pool(const thread_pool &) = delete;
+            thread_pool &operator=(const thread_pool &) = delete;
+            /**
+             * finishes the queued tasks, then joins the workers.
+             */
+            ~thread_pool(){
+                {
+                    std::lock_guard<std::mutex> guard(sleepLock);
+                    stopping = true;
+                }
+                wake.notify_all();
+                size_t i;
+                for(i = 0; i < threads.size(); i++){
+                    threads[i].join();
+                }
+                delete [] workers;
+            }
+            /**
+             * the pool the parallel algorithms use unless told otherwise.
+             */
+            static thread_pool &instance(){
+                static thread_pool pool;
+                return pool;
+            }
+            size_t size() const {
+                return workerCnt;
+            }
+            /**
+             * queue a task: on the caller's own queue from a worker, round robin otherwise.
+             */
+            void submit(taskT task){
+                slotT &me = self();
+                size_t id = me.pool == this ? me.id : nextWorker++ % workerCnt;
+                {
+                    std::lock_guard<std::mutex> guard(workers[id].lock);
+                    workers[id].tasks.push_back(std::move(task));
+                }
+                {
+                    std::lock_guard<std::mutex> guard(sleepLock);
+                    pending++;
+                }
+                wake.notify_one();
+            }
+            /**
+             * run fn(0), ..., fn(n - 1) as tasks and return when all of them are done,
+             * running queued tasks meanwhile. rethrows the first exception a task threw.
+             */
+            template<class F>
+            void run(size_t n, const F &fn){
+                if(n == 1){
+                    fn(0);
+                    return;
+                }
+                std::atomic<size_t> left(n);
+                std::mutex doneLock;
+                std::condition_variable done;
+                std::exception_ptr error;
+                size_t i;
+                for(i = 0; i < n; i++){
+                    submit([&, i]{
+                        std::exception_ptr e;
+                        try{
+                            fn(i);
+                        }
+                        catch(...){
+                            e = std::current_exception();
+                        }
+                        // under the lock, so run cannot return while the last task still touches its locals.
+                        std::lock_guard<std::mutex> guard(doneLock);
+                        if(e && !error){
+                            error = e;
+                        }
+                        if(--left == 0){
+                            done.notify_all();
+                        }
+                    });
+                }
+                while(left != 0){
+                    if(runOne()){
+                        continue;
+                    }
+                    // the rest of ours are running elsewhere.
+                    std::unique_lock<std::mutex> guard(doneLock);
+                    done.wait(guard, [&left]{ return left == 0; });
+                }
+                std::lock_guard<std::mutex> guard(doneLock);
+                if(error){
+                    std::rethrow_exception(error);
+                }
+            }
+        };
+
+        // no more tasks than this per call, so small ranges are not shredded.
+        const size_t taskLimit = 64;
+
+        // the groups of [first, last): tasks() of them, group k is [cut(k), cut(k + 1)).
+        template<class It>
+        struct nodeGroups{
+            It first;
+            It last;
+            size_t span;
+            size_t per;
+            nodeGroups(It f, It l) : first(f), last(l) {
+                span = It::segmented_deque::nodeSpan(first, last);
+                per = span == 0 ? 1 : (span + taskLimit - 1) / taskLimit;
+            }
+            size_t tasks() const {
+                return span == 0 ? 0 : (span + per - 1) / per;
+            }
+            It cut(size_t k) const {
+                return It::segmented_deque::nodeCut(first, last, k * per);
+            }
+        };
+
+        /**
+         * f(x) for every element, in no particular order.
+         */
+        template<class It, class F>
+        void for_each(thread_pool &pool, It first, It last, F f){
+            nodeGroups<It> g(first, last);
+            pool.run(g.tasks(), [&g, &f](size_t k){
+                segmented::for_each(g.cut(k), g.cut(k + 1), f);
+            });
+        }
+        template<class It, class F>
+        void for_each(It first, It last, F f){
+            parallel::for_each(thread_pool::instance(), first, last, f);
+        }
+
+        /**
+         * out[i] = op(first[i]); out is a random access iterator, the result is out + (last - first).
+         */
+        template<class It, class OutputIt, class Op>
+        OutputIt transform(thread_pool &pool, It first, It last, OutputIt out, Op op){
+            nodeGroups<It> g(first, last);
+            pool.run(g.tasks(), [&g, &out, &op](size_t k){
+                It b = g.cut(k);
+                segmented::transform(b, g.cut(k + 1), out + (b - g.first), op);
+            });
+            return out + (last - first);
+        }
+        template<class It, class OutputIt, class Op>
+        OutputIt transform(It first, It last, OutputIt out, Op op){
+            return parallel::transform(thread_pool::instance(), first, last, out, op);
+        }
+
+        /**
+         * init op x0 op x1 ..., op being associative; every group is folded from its
+         * first element, then init and the group results are folded in order.
+         */
+        template<class It, class V, class Op>
+        V reduce(thread_pool &pool, It first, It last, V init, Op op){
+            nodeGroups<It> g(first, last);
+            size_t n = g.tasks();
+            std::vector<V> part(n, init);
+            pool.run(n, [&g, &op, &part](size_t k){
+                It b = g.cut(k), e = g.cut(k + 1);
+                if(b != e){
+                    part[k] = segmented::accumulate(b + 1, e, V(*b), op);
+                }
+            });
+            size_t k;
+            for(k = 0; k < n; k++){
+                if(g.cut(k) != g.cut(k + 1)){
+                    init = op(std::move(init), part[k]);
+                }
+            }
+            return init;
+        }
+        template<class It, class V, class Op>
+        V reduce(It first, It last, V init, Op op){
+            return parallel::reduce(thread_pool::instance(), first, last, std::move(init), op);
+        }
+        template<class It, class V>
+        V reduce(It first, It last, V init){
+            return parallel::reduce(thread_pool::instance(), first, last, std::move(init), segmented::plus());
+        }
+    }
+#endif
 }
 
 #endif